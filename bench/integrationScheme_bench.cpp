@@ -0,0 +1,50 @@
+/**
+ * @file integrationScheme_bench.cpp
+ * @date 16-oct-2026
+ * Headless frame timing for the integrationScheme example, see
+ * dl2hub/frame_bench.h
+ */
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <dl2hub/frame_bench.h>
+
+#define main integrationScheme_main
+#include "../example/integrationScheme.cpp"
+#undef main
+
+
+int main(int argc, char const *argv[])
+{
+    dl2hub::FrameBench bench("integrationScheme", argc, argv);
+    canvas.w = 640;
+    canvas.h = 480;
+    if(!bench.open(canvas.w, canvas.h)) return 1;
+    canvas.renderer = bench.getRenderer();
+
+    bool shouldOpen = true;
+    SDL_Event evt;
+    bench.stage("init", init);
+    while (bench.nextFrame())
+    {
+        // drop the ball again once it has fallen off the screen
+        if(ball.pos.y > canvas.h + ball.radius) {
+            ball.vel = Vec2{ 0.0f, 0.0f };
+            init();
+        }
+
+        // mainLoop() split into its stages
+        bench.stage("events", [&]() {
+            while (SDL_PollEvent(&evt))
+                processEvent(evt, shouldOpen);
+        });
+        bench.stage("update", [&]() { update(bench.getDt()); });
+        bench.stage("render", [&]() {
+            SDL_SetRenderDrawColor(canvas.renderer, 0xff, 0xff, 0xff, 0xff);
+            SDL_RenderClear(canvas.renderer);
+            render(canvas.renderer);
+        });
+        bench.stage("present", [&]() { SDL_RenderPresent(canvas.renderer); });
+    }
+    circles.clear();
+    return bench.report();
+}
@@ -0,0 +1,46 @@
+/**
+ * @file pong2d_bench.cpp
+ * @date 16-oct-2026
+ * Headless frame timing for the pong2d example, see dl2hub/frame_bench.h
+ */
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <dl2hub/frame_bench.h>
+
+#define main pong2d_main
+#include "../example/pong2d.cpp"
+#undef main
+
+
+int main(int argc, char const *argv[])
+{
+    dl2hub::FrameBench bench("pong2d", argc, argv);
+    if(!bench.open(W, H)) return 1;
+    window = bench.getWindow();
+    renderer = bench.getRenderer();
+
+    // start a round, then keep the paddle moving; space also restarts a
+    // round that was lost
+    for(int f = 5; f < 100000; f += 120) {
+        bench.press(f, SDLK_SPACE);
+        bench.press(f + 10, SDLK_UP, 40);
+        bench.press(f + 60, SDLK_DOWN, 40);
+    }
+
+    bench.stage("init", onCreate);
+    while (bench.nextFrame())
+    {
+        // mainLoop() split into its stages, onDraw() presents the frame itself
+        bench.stage("events", [&]() {
+            while(SDL_PollEvent(&evt))
+                onPollEvent(evt);
+        });
+        bench.stage("update", [&]() { onUpdate(state == GameState::PLAYING ? bench.getDt() : 0.0f); });
+        bench.stage("draw", onDraw);
+    }
+
+    // onExit() would tear down the window the bench owns, the circles go
+    // before the bench destroys its renderer
+    circles.clear();
+    return bench.report();
+}
@@ -0,0 +1,50 @@
+/**
+ * @file raycasting3d_bench.cpp
+ * @date 16-oct-2026
+ * Headless frame timing for the raycasting3d example, see dl2hub/frame_bench.h
+ */
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <dl2hub/frame_bench.h>
+
+#define main raycasting3d_main
+#include "../example/raycasting3d/raycasting3d.cpp"
+#undef main
+
+
+int main(int argc, char const *argv[])
+{
+    dl2hub::FrameBench bench("raycasting3d", argc, argv);
+    canvas.w = 1024;
+    canvas.h = 512;
+    if(!bench.open(canvas.w, canvas.h)) return 1;
+    canvas.window = bench.getWindow();
+    canvas.renderer = bench.getRenderer();
+
+    // turn on the spot, then walk back and forth
+    for(int f = 10; f < 100000; f += 200) {
+        bench.press(f, SDLK_RIGHT, 60);
+        bench.press(f + 70, SDLK_UP, 40);
+        bench.press(f + 120, SDLK_LEFT, 30);
+        bench.press(f + 160, SDLK_DOWN, 30);
+    }
+
+    bench.stage("init", init);
+    while (bench.nextFrame())
+    {
+        // gameLoop() split into its stages
+        bench.stage("events", [&]() {
+            while (SDL_PollEvent(&evt))
+                processEvent(evt, shouldQuit);
+        });
+        bench.stage("update", [&]() { update(bench.getDt()); });
+        bench.stage("render", [&]() {
+            SDL_SetRenderDrawColor(canvas.renderer, 0x00, 0x00, 0x00, 0x00);
+            SDL_RenderClear(canvas.renderer);
+            render(canvas.renderer);
+        });
+        bench.stage("present", [&]() { SDL_RenderPresent(canvas.renderer); });
+    }
+    circles.clear();
+    return bench.report();
+}
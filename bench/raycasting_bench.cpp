@@ -0,0 +1,51 @@
+/**
+ * @file raycasting_bench.cpp
+ * @date 16-oct-2026
+ * Headless frame timing for the rcc based raycasting example, see
+ * dl2hub/frame_bench.h
+ */
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <dl2hub/frame_bench.h>
+
+#define main raycasting_main
+#include "../example/raycasting/main.cpp"
+#undef main
+
+
+int main(int argc, char const *argv[])
+{
+    dl2hub::FrameBench bench("raycasting", argc, argv);
+    canvas.w = 1024;
+    canvas.h = canvas.w / 2;
+    if(!bench.open(canvas.w, canvas.h)) return 1;
+    canvas.renderer = bench.getRenderer();
+
+    // walk forward, turn and come back
+    for(int f = 10; f < 100000; f += 200) {
+        bench.press(f, SDLK_UP, 40);
+        bench.press(f + 50, SDLK_RIGHT, 60);
+        bench.press(f + 120, SDLK_DOWN, 40);
+        bench.press(f + 170, SDLK_LEFT, 20);
+    }
+
+    bool shouldQuit = false;
+    SDL_Event evt;
+    bench.stage("init", init);
+    while (bench.nextFrame())
+    {
+        // mainLoop() split into its stages
+        bench.stage("events", [&]() {
+            while (SDL_PollEvent(&evt))
+                processEvent(evt, shouldQuit);
+        });
+        bench.stage("update", [&]() { update(bench.getDt()); });
+        bench.stage("render", [&]() {
+            SDL_SetRenderDrawColor(canvas.renderer, 0x00, 0x00, 0x00, 0x00);
+            SDL_RenderClear(canvas.renderer);
+            render(canvas.renderer);
+        });
+        bench.stage("present", [&]() { SDL_RenderPresent(canvas.renderer); });
+    }
+    return bench.report();
+}
@@ -0,0 +1,47 @@
+/**
+ * @file tetris_bench.cpp
+ * @date 16-oct-2026
+ * Headless frame timing for the tetris example, see dl2hub/frame_bench.h
+ */
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <dl2hub/frame_bench.h>
+
+// the example is compiled into this file with its main renamed, so the
+// bench drives the real init, update and render
+#define main tetris_main
+#include "../example/tetris/tetris.cpp"
+#undef main
+
+
+int main(int argc, char const *argv[])
+{
+    dl2hub::FrameBench bench("tetris", argc, argv);
+    if(!bench.open(640, 640)) return 1;
+    canvas.window = bench.getWindow();
+    canvas.renderer = bench.getRenderer();
+    canvas.width = 640;
+    canvas.height = 640;
+
+    // shuffle and turn the falling pieces, dropping one a little faster
+    for(int f = 20; f < 100000; f += 90) {
+        bench.press(f, SDLK_LEFT);
+        bench.press(f + 15, SDLK_d);
+        bench.press(f + 30, SDLK_RIGHT);
+        bench.press(f + 45, SDLK_DOWN);
+    }
+
+    bench.stage("init", init);
+    while (bench.nextFrame())
+    {
+        // same order as loop(), with a fixed time step
+        bench.stage("render", [&]() { render(canvas.renderer); });
+        bench.stage("update", [&]() { update(bench.getDt()); });
+        bench.stage("events", [&]() {
+            while (SDL_PollEvent(&canvas.evt))
+                processEvent(canvas.evt);
+        });
+        bench.stage("present", [&]() { SDL_RenderPresent(canvas.renderer); });
+    }
+    return bench.report();
+}
@@ -4,6 +4,9 @@
 #include <cassert>
 
 #include <SDL.h>
+#include <dl2hub/circle.h>
+#include <dl2hub/fixed_timestep.h>
+#include <dl2hub/profiler.h>
 
 struct {
     SDL_Renderer* renderer = nullptr;
@@ -64,8 +67,13 @@ struct Ball
     
 } ball;
 
+// where the ball was before the last update, render() draws it renderAlpha
+// of the way from there to ball.pos
+Vec2 previousPos;
+float renderAlpha = 1.0f;
 
-void drawFilledCircle(SDL_Renderer *r, float px, float py, float radius);
+
+dl2hub::CircleCache circles;
 
 
 float toRadian(float angleInDegrees) {
@@ -82,6 +90,7 @@ void init()
     ball.pos.x = canvas.w / 2;
     ball.pos.y = 0;
     ball.radius = 20;
+    previousPos = ball.pos;
 }
 
 Vec2 getAcc(Vec2 vel) {
@@ -123,20 +132,26 @@ void rk2(Ball& b, float dt) {
 
 void update(float dt)
 {   
+    DL2HUB_PROFILE_SCOPE("update");
     // eulerExplicit(ball.pos, ball.vel, acc, dt);
     // eulerSemiImplicit(ball.pos, ball.vel, acc, dt);
+    previousPos = ball.pos;
     rk2(ball, dt);
 }
 
 
 void render(SDL_Renderer* renderer)
 {
+    DL2HUB_PROFILE_SCOPE("render");
     SDL_SetRenderDrawColor(renderer, 0xff, 0x00, 0x00, 0xff);
-    drawFilledCircle(renderer, ball.pos.x, ball.pos.y, ball.radius);
+    const Vec2 pos = dl2hub::interpolate(previousPos, ball.pos, renderAlpha);
+    circles.draw(renderer, pos.x, pos.y, ball.radius);
 }
 
 
 void processEvent(SDL_Event& evt, bool& shouldOpen) {
+    DL2HUB_PROFILE_SCOPE("events");
+    if(dl2hub::Profiler::get().handleEvent(evt)) return;
     if(evt.type == SDL_QUIT) {
         shouldOpen = false;
         return;
@@ -173,50 +188,26 @@ void processEvent(SDL_Event& evt, bool& shouldOpen) {
 
 void mainLoop()
 {
+    dl2hub::FixedTimestep timestep;
     SDL_Event evt;
     bool shouldOpen = true;
     while (shouldOpen)
     {
         while (SDL_PollEvent(&evt))
             processEvent(evt, shouldOpen);
+        timestep.advance(update);
+        renderAlpha = timestep.getAlpha();
         SDL_SetRenderDrawColor(canvas.renderer, 0xff, 0xff, 0xff, 0xff);
         SDL_RenderClear(canvas.renderer);
         render(canvas.renderer);
-        update(1 / 60.0f);  //@todo: use real timing
-        SDL_RenderPresent(canvas.renderer);
-    }
-    
-}
-
-
-void drawFilledCircle(SDL_Renderer *r, float px, float py, float radius)
-{
-    auto drawHorizontalLine = [](SDL_Renderer* renderer, int x1, int x2, int y) -> void {
-        for (int x = x1; x <= x2; x++)
-            SDL_RenderDrawPoint(renderer, x, y);
-    };
-    
-    int x = 0;
-    int y = radius;
-    int d = 3 - int(radius) << 1;
-
-    while (y >= x) {
-        // Draw horizontal lines (scanlines) for each section of the circle
-        drawHorizontalLine(r, px - x, px + x, py - y);
-        drawHorizontalLine(r, px - x, px + x, py + y);
-        drawHorizontalLine(r, px - y, px + y, py - x);
-        drawHorizontalLine(r, px - y, px + y, py + x);
-
-        // Update decision parameter and points
-        if (d < 0) {
-            d = d + (x << 2) + 6;
-        } else {
-            d = d + ((x - y) << 2) + 10;
-            y--;
+        dl2hub::Profiler::get().drawHud(canvas.renderer);
+        {
+            DL2HUB_PROFILE_SCOPE("present");
+            SDL_RenderPresent(canvas.renderer);
         }
-        x++;
-        
+        dl2hub::Profiler::get().endFrame();
     }
+    
 }
 
 
@@ -244,6 +235,7 @@ int main(int argc, char const *argv[])
     init();
     mainLoop();
 
+    circles.clear();
     SDL_DestroyWindow(window);
     SDL_Quit();
     return 0;
@@ -1,4 +1,6 @@
 #include <SDL.h>
+#include <dl2hub/circle.h>
+#include <dl2hub/profiler.h>
 #include <vector>
 #include <cmath>
 #include <chrono>
@@ -58,7 +60,7 @@ bool mainLoop();
 float randRange(float min, float max);
 void collideWorldBoundary(Player& p);
 bool isBallAndPlayerCollision(Player& paddle, Vec2 ball);
-void drawFilledCircle(SDL_Renderer *r, float px, float py, float radius);
+dl2hub::CircleCache circles;
 
 
 int main(int argc, char* argv[]) {
@@ -90,6 +92,7 @@ bool isBallAndPlayerCollision(Player& paddle, Vec2 ball) {
 }
 
 bool onUpdate(float dt) {
+    DL2HUB_PROFILE_SCOPE("update");
     ball.x += ballVelocity.x * dt;
     ball.y += ballVelocity.y * dt;
 
@@ -135,6 +138,7 @@ bool onUpdate(float dt) {
 
 
 bool onDraw() {
+    DL2HUB_PROFILE_SCOPE("render");
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
     SDL_RenderClear(renderer);
 
@@ -142,7 +146,7 @@ bool onDraw() {
     SDL_RenderDrawLine(renderer, W * 0.5f, 0.0f, W * 0.5f, H);
 
     SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0xff, 0xff);
-    drawFilledCircle(renderer, ball.x, ball.y, BALL_RADIUS * 0.5);
+    circles.draw(renderer, ball.x, ball.y, BALL_RADIUS * 0.5);
 
     Player::drawRect.x = opponent.position.x;
     Player::drawRect.y = opponent.position.y;
@@ -154,12 +158,18 @@ bool onDraw() {
     SDL_SetRenderDrawColor(renderer, 0x00, 0xff, 0x00, 0xff);
     SDL_RenderFillRectF(renderer, &Player::drawRect);
 
-    SDL_RenderPresent(renderer);
+    dl2hub::Profiler::get().drawHud(renderer);
+    {
+        DL2HUB_PROFILE_SCOPE("present");
+        SDL_RenderPresent(renderer);
+    }
     return true;
 }
 
 
 bool onPollEvent(SDL_Event& evt) {
+    DL2HUB_PROFILE_SCOPE("events");
+    if(dl2hub::Profiler::get().handleEvent(evt)) return true;
     bool res = true;
     switch(evt.type) {
         case SDL_QUIT:
@@ -212,6 +222,7 @@ bool mainLoop() {
 
         onUpdate(dt);
         onDraw();
+        dl2hub::Profiler::get().endFrame();
     }
     
     return true;
@@ -280,6 +291,7 @@ bool onCreate() {
 }
 
 bool onExit() {
+    circles.clear();
     SDL_DestroyWindow(window);
     SDL_Quit();
     std::cout << std::flush;    // incase there is something hanging on the stdout buffer
@@ -287,37 +299,6 @@ bool onExit() {
 }
 
 
-void drawFilledCircle(SDL_Renderer *r, float px, float py, float radius)
-{
-    auto drawHorizontalLine = [](SDL_Renderer* renderer, int x1, int x2, int y) -> void {
-        for (int x = x1; x <= x2; x++)
-            SDL_RenderDrawPoint(renderer, x, y);
-    };
-    
-    int x = 0;
-    int y = radius;
-    int d = 3 - int(radius) << 1;
-
-    while (y >= x) {
-        // Draw horizontal lines (scanlines) for each section of the circle
-        drawHorizontalLine(r, px - x, px + x, py - y);
-        drawHorizontalLine(r, px - x, px + x, py + y);
-        drawHorizontalLine(r, px - y, px + y, py - x);
-        drawHorizontalLine(r, px - y, px + y, py + x);
-
-        // Update decision parameter and points
-        if (d < 0) {
-            d = d + (x << 2) + 6;
-        } else {
-            d = d + ((x - y) << 2) + 10;
-            y--;
-        }
-        x++;
-        
-    }
-}
-
-
 bool init(const char* title, int w, int h) {
     if(SDL_Init(SDL_INIT_VIDEO) != 0) return false;
     std::cout << "SDL3 initialized\n";
@@ -4,6 +4,8 @@
 #include <cassert>
 
 #include <SDL.h>
+#include <dl2hub/circle.h>
+#include <dl2hub/fixed_timestep.h>
 
 struct {
     SDL_Renderer* renderer = nullptr;
@@ -82,7 +84,7 @@ const int MAP_COL = 8;
 const int MAP_ROW = 8;
 const int TILE_SIZE = 32;
 
-void drawFilledCircle(SDL_Renderer *r, float px, float py, float radius);
+dl2hub::CircleCache circles;
 
 
 float toRadian(float angleInDegrees) {
@@ -187,7 +189,7 @@ void render(SDL_Renderer* renderer)
     SDL_RenderDrawLine(renderer, player.pos.x, player.pos.y, sdx, sdy);
 
     SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0xff, 0xff);
-    drawFilledCircle(renderer, player.pos.x, player.pos.y, 5);    
+    circles.draw(renderer, player.pos.x, player.pos.y, 5);    
 
 }
 
@@ -229,53 +231,23 @@ void processEvent(SDL_Event& evt, bool& shouldOpen) {
 
 void mainLoop()
 {
+    dl2hub::FixedTimestep timestep;
     SDL_Event evt;
     bool shouldOpen = true;
     while (shouldOpen)
     {
         while (SDL_PollEvent(&evt))
             processEvent(evt, shouldOpen);
+        timestep.advance(update);
         SDL_SetRenderDrawColor(canvas.renderer, 0xff, 0xff, 0xff, 0xff);
         SDL_RenderClear(canvas.renderer);
         render(canvas.renderer);
-        update(1 / 60.0f);  //@todo: use real timing
         SDL_RenderPresent(canvas.renderer);
     }
     
 }
 
 
-void drawFilledCircle(SDL_Renderer *r, float px, float py, float radius)
-{
-    auto drawHorizontalLine = [](SDL_Renderer* renderer, int x1, int x2, int y) -> void {
-        for (int x = x1; x <= x2; x++)
-            SDL_RenderDrawPoint(renderer, x, y);
-    };
-    
-    int x = 0;
-    int y = radius;
-    int d = 3 - int(radius) << 1;
-
-    while (y >= x) {
-        // Draw horizontal lines (scanlines) for each section of the circle
-        drawHorizontalLine(r, px - x, px + x, py - y);
-        drawHorizontalLine(r, px - x, px + x, py + y);
-        drawHorizontalLine(r, px - y, px + y, py - x);
-        drawHorizontalLine(r, px - y, px + y, py + x);
-
-        // Update decision parameter and points
-        if (d < 0) {
-            d = d + (x << 2) + 6;
-        } else {
-            d = d + ((x - y) << 2) + 10;
-            y--;
-        }
-        x++;
-        
-    }
-}
-
-
 int main(int argc, char const *argv[])
 {
     if(SDL_Init(SDL_INIT_VIDEO) < 0) {
@@ -300,6 +272,7 @@ int main(int argc, char const *argv[])
     init();
     mainLoop();
 
+    circles.clear();
     SDL_DestroyWindow(window);
     SDL_Quit();
     return 0;
@@ -0,0 +1,737 @@
+/**
+ * @file rcc_bench.cpp
+ * @date 16-oct-2026
+ * Micro-benchmarks for the rcc ray caster. Every section prints one line
+ * per variant so runs can be diffed before and after a change; build in
+ * Release for meaningful numbers.
+ */
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <sstream>
+#include <filesystem>
+#include <cstdio>
+#include <cmath>
+#include <limits>
+
+#include "../include/rcc.h"
+#include "../include/rcc_map.h"
+#include "../include/rcc_stream.h"
+#include "../include/rcc_sprite.h"
+
+
+using Clock = std::chrono::steady_clock;
+
+volatile long long sink = 0;    // keeps the optimizer from dropping measured work
+
+
+/// @brief Run fn repeatedly and return the best time of a few repetitions
+/// @param fn is the work to measure
+/// @return the fastest repetition in seconds
+template<typename Fn>
+double measure(Fn&& fn)
+{
+    double best = 1e30;
+    for(int rep = 0; rep < 5; rep++)
+    {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if(s < best) best = s;
+    }
+    return best;
+}
+
+
+void report(const std::string& section, const std::string& variant, double perSecond, const std::string& unit)
+{
+    std::cout << std::left << std::setw(12) << section << std::setw(28) << variant
+              << std::right << std::setw(14) << std::fixed << std::setprecision(0) << perSecond
+              << " " << unit << std::endl;
+}
+
+
+/// @brief Build an n*n map without border walls, sparsely filled with pillars,
+/// so most rays leave the map instead of hitting a wall
+std::vector<int> makeEscapeMap(int n, float density, unsigned seed = 7)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    std::vector<int> map(n * n, 0);
+    for(auto& id: map)
+        id = dis(gen) < density ? 1 : 0;
+    map[(n / 2) * n + n / 2] = 0;
+    return map;
+}
+
+
+// the lookup rcc::World::getMapId used before it was made exception free
+int legacyGetMapId(const std::vector<int>& map, int colSize, int y, int x)
+{
+    int res;
+    try {
+        res = map.at(y * colSize + x);
+    } catch(...) {
+        res = -1;
+    }
+    return res;
+}
+
+
+void benchMapLookup()
+{
+    const int n = 64;
+    auto map = makeEscapeMap(n, 0.05f);
+    auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+    world->setWorldInfo(map, n, n);
+
+    // about three quarters of the probes land outside the map
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> dis(-n, 2 * n - 1);
+    std::vector<std::pair<int, int>> probes(1 << 16);
+    for(auto& p: probes) p = { dis(gen), dis(gen) };
+
+    double t = measure([&]() {
+        long long acc = 0;
+        for(const auto& [y, x]: probes) acc += legacyGetMapId(map, n, y, x);
+        sink = sink + acc;
+    });
+    report("lookup", "try/at/catch", probes.size() / t, "lookups/s");
+
+    t = measure([&]() {
+        long long acc = 0;
+        for(const auto& [y, x]: probes) acc += world->getMapId(y, x);
+        sink = sink + acc;
+    });
+    report("lookup", "World::getMapId", probes.size() / t, "lookups/s");
+}
+
+
+/// @brief The grid DDA castRay had when getMapId was made exception free,
+/// with the tile lookup passed in, so the two lookups can be compared in
+/// rays per second on the same traversal
+/// @param lookup is called as lookup(y, x) for every cell a ray enters and
+/// stops the ray on anything but 0
+/// @return the sum of the hit cells, to keep the work from being dropped
+template<typename Lookup>
+long long castLookupRays(rcc::Vector pos, float rotation, float fov, int count, int tileSize, Lookup&& lookup)
+{
+    const rcc::Vector origin = pos * (1.0f / tileSize);
+    const int originX = std::floor(origin.x);
+    const int originY = std::floor(origin.y);
+    const float inf = std::numeric_limits<float>::infinity();
+
+    long long acc = 0;
+    for(int i = 0; i < count; i++)
+    {
+        const rcc::Vector dir = rcc::Vector::fromAngle(rcc::degToRad(rotation - fov * 0.5f + fov * i / count));
+        const int stepX = dir.x < 0.0f ? -1 : 1;
+        const int stepY = dir.y < 0.0f ? -1 : 1;
+        const float tDeltaX = dir.x != 0.0f ? std::abs(1.0f / dir.x) : inf;
+        const float tDeltaY = dir.y != 0.0f ? std::abs(1.0f / dir.y) : inf;
+        float tMaxX = dir.x != 0.0f ? (stepX < 0 ? origin.x - originX : originX + 1 - origin.x) * tDeltaX : inf;
+        float tMaxY = dir.y != 0.0f ? (stepY < 0 ? origin.y - originY : originY + 1 - origin.y) * tDeltaY : inf;
+
+        int tx = originX, ty = originY;
+        int id = 0;
+        while (id == 0)
+        {
+            if(tMaxX < tMaxY) {
+                tx += stepX;
+                tMaxX += tDeltaX;
+            } else {
+                ty += stepY;
+                tMaxY += tDeltaY;
+            }
+            id = lookup(ty, tx);
+        }
+        acc += tx + ty;
+    }
+    return acc;
+}
+
+
+void benchEscapingRays()
+{
+    const int n = 256;
+    auto map = makeEscapeMap(n, 0.01f);
+    auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+    world->setWorldInfo(map, n, n);
+
+    rcc::RayCastable viewer(60.0f, 0.0f, 1920);
+    viewer.pos = rcc::Vector{ (n / 2 + 0.5f) * 64, (n / 2 + 0.5f) * 64 };
+    const int rays = int(viewer.getRayBuffer().size());
+    const int frames = 36;
+
+    // the traversal of the time with either lookup, then castRay as it is now
+    double t = measure([&]() {
+        long long acc = 0;
+        for(int f = 0; f < frames; f++)
+            acc += castLookupRays(viewer.pos, f * 10.0f, 60.0f, rays, 64,
+                                  [&](int y, int x) { return legacyGetMapId(map, n, y, x); });
+        sink = sink + acc;
+    });
+    report("castRay", "DDA, try/at/catch lookup", rays * frames / t, "rays/s");
+
+    t = measure([&]() {
+        long long acc = 0;
+        for(int f = 0; f < frames; f++)
+            acc += castLookupRays(viewer.pos, f * 10.0f, 60.0f, rays, 64,
+                                  [&](int y, int x) { return world->getMapId(y, x); });
+        sink = sink + acc;
+    });
+    report("castRay", "DDA, World::getMapId", rays * frames / t, "rays/s");
+
+    t = measure([&]() {
+        for(int f = 0; f < frames; f++) {
+            viewer.rotation = f * 10.0f;
+            viewer.castRay(*world);
+        }
+        sink = sink + viewer.getRayBuffer().size();
+    });
+    report("castRay", "open 256x256, 1% filled", rays * frames / t, "rays/s");
+}
+
+
+void benchParallelUpdate()
+{
+    const int n = 256;
+    auto map = makeEscapeMap(n, 0.05f);
+    auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+    world->setWorldInfo(map, n, n);
+
+    rcc::RayCastable player(60.0f, 0.0f, 1920);
+    player.pos = rcc::Vector{ (n / 2 + 0.5f) * 64, (n / 2 + 0.5f) * 64 };
+    world->setPlayer(player);
+
+    // guards casting 90 degree vision cones around the player
+    for(int i = 0; i < 32; i++) {
+        rcc::RayCastable guard(90.0f, 0.0f, 90);
+        guard.pos = player.pos + rcc::Vector::fromAngle(i * 0.2f, 64.0f * (2 + i % 7));
+        guard.rotation = i * 11.0f;
+        world->addCastable(guard);
+    }
+
+    size_t raysPerFrame = player.getRayBuffer().size();
+    for(auto& c: world->getCastables()) raysPerFrame += c.getRayBuffer().size();
+
+    std::vector<unsigned> workerCounts{ 0 };
+    if(std::thread::hardware_concurrency() > 1)
+        workerCounts.push_back(std::thread::hardware_concurrency() - 1);
+
+    for(unsigned workers: workerCounts)
+    {
+        world->setWorkerCount(workers);
+        const int frames = 20;
+        double t = measure([&]() {
+            for(int f = 0; f < frames; f++) {
+                // turn everyone, a stationary castable would be skipped
+                player.rotation = f * 18.0f;
+                for(auto& c: world->getCastables()) c.rotation += 1.0f;
+                world->update(1 / 60.0f);
+            }
+        });
+        report("update", std::to_string(workers + 1) + " thread(s)", raysPerFrame * frames / t, "rays/s");
+    }
+}
+
+
+void benchIncrementalUpdate()
+{
+    const int n = 256;
+    auto map = makeEscapeMap(n, 0.05f);
+    auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+    world->setWorldInfo(map, n, n);
+
+    rcc::RayCastable player(60.0f, 0.0f, 1920);
+    player.pos = rcc::Vector{ (n / 2 + 0.5f) * 64, (n / 2 + 0.5f) * 64 };
+    world->setPlayer(player);
+
+    for(int i = 0; i < 64; i++) {
+        rcc::RayCastable guard(90.0f, i * 11.0f, 90);
+        guard.pos = player.pos + rcc::Vector::fromAngle(i * 0.2f, 64.0f * (2 + i % 7));
+        world->addCastable(guard);
+    }
+
+    // the player turns every frame, guards move in `moving` of every 8 frames
+    const int frames = 40;
+    for(int moving: { 8, 1, 0 })
+    {
+        size_t skipped = 0;
+        double t = measure([&]() {
+            skipped = 0;
+            for(int f = 0; f < frames; f++) {
+                player.rotation = f * 9.0f;
+                if(f % 8 < moving)
+                    for(auto& c: world->getCastables()) c.rotation += 1.0f;
+                world->update(1 / 60.0f);
+                skipped += world->getSkippedCasts();
+            }
+        });
+        report("update", "guards move " + std::to_string(moving) + "/8 frames", frames / t, "frames/s");
+        std::cout << "  skipped casts per frame: " << skipped / frames << std::endl;
+    }
+}
+
+
+void benchTurnInPlace()
+{
+    const int n = 256;
+    auto map = makeEscapeMap(n, 0.05f);
+    auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+    world->setWorldInfo(map, n, n);
+
+    rcc::RayCastable player(60.0f, 0.0f, 1920);
+    player.pos = rcc::Vector{ (n / 2 + 0.5f) * 64, (n / 2 + 0.5f) * 64 };
+    world->setPlayer(player);
+
+    // 8 columns a frame lines up with the previous view, 8.5 does not
+    const int frames = 200;
+    const float column = 60.0f / 1920;
+    for(float step: { 8.5f, 8.0f })
+    {
+        double t = measure([&]() {
+            for(int f = 0; f < frames; f++) {
+                player.rotation += step * column;
+                world->update(1 / 60.0f);
+            }
+        });
+        report("turn", std::to_string(step).substr(0, 3) + " columns a frame", frames / t, "frames/s");
+    }
+}
+
+
+// the 8x8 layouts of raycasting/main.cpp and raycasting3d.cpp
+const std::vector<int> exampleLayouts[] = {
+    {
+        1,1,1,1,1,1,1,1,
+        1,0,0,0,0,1,0,1,
+        1,0,0,1,0,0,0,1,
+        1,0,1,1,1,1,0,1,
+        1,0,0,1,0,1,0,1,
+        1,0,0,0,1,0,0,1,
+        1,0,0,0,0,0,0,1,
+        1,1,1,1,1,1,1,1,
+    },
+    {
+        1,1,1,1,1,1,1,1,
+        1,0,0,0,0,1,0,1,
+        1,0,1,0,0,0,0,1,
+        1,0,1,1,0,1,0,1,
+        1,0,0,1,0,1,0,1,
+        1,0,0,1,1,1,0,1,
+        1,0,0,1,0,0,0,1,
+        1,1,1,1,1,1,1,1,
+    },
+};
+
+
+/// @brief Scale an 8x8 layout up to n*n by repeating each cell
+std::vector<int> scaleLayout(const std::vector<int>& layout, int n)
+{
+    std::vector<int> map(n * n);
+    for(int y = 0; y < n; y++)
+        for(int x = 0; x < n; x++)
+            map[y * n + x] = layout[(y * 8 / n) * 8 + x * 8 / n];
+    return map;
+}
+
+
+void benchPacketCasting()
+{
+    const int n = 1024;
+    for(size_t layout = 0; layout < std::size(exampleLayouts); layout++)
+    {
+        auto map = scaleLayout(exampleLayouts[layout], n);
+        auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+        world->setWorldInfo(map, n, n);
+
+        // centre of cell (1, 1) of the layout, which is empty in both
+        rcc::RayCastable scalar(60.0f, 0.0f, 1920);
+        scalar.pos = rcc::Vector{ 1.5f * n / 8 * 64, 1.5f * n / 8 * 64 };
+        rcc::RayCastable packets = scalar;
+
+        // the packet caster has to stop in exactly the cells the scalar one does
+        size_t mismatches = 0;
+        for(int f = 0; f < 36; f++) {
+            scalar.rotation = packets.rotation = f * 10.0f;
+            scalar.castRay(*world);
+            packets.castRayPackets(*world, 0, packets.getRayBuffer().size());
+            const auto& a = scalar.getRayBuffer();
+            const auto& b = packets.getRayBuffer();
+            for(size_t i = 0; i < a.size(); i++)
+                mismatches += a.cellX[i] != b.cellX[i] || a.cellY[i] != b.cellY[i] || a.isVert[i] != b.isVert[i];
+        }
+
+        const std::string name = "layout " + std::to_string(layout) + " " + std::to_string(n) + "^2";
+        const int frames = 36;
+        const size_t rays = scalar.getRayBuffer().size();
+        double t = measure([&]() {
+            for(int f = 0; f < frames; f++) {
+                scalar.rotation = f * 10.0f;
+                scalar.castRay(*world);
+            }
+        });
+        report("scalar", name, rays * frames / t, "rays/s");
+
+        t = measure([&]() {
+            for(int f = 0; f < frames; f++) {
+                packets.rotation = f * 10.0f;
+                packets.castRayPackets(*world, 0, rays);
+            }
+        });
+        report("packet x" + std::to_string(RCC_PACKET_WIDTH), name, rays * frames / t, "rays/s");
+        std::cout << "  packet hit cells differing from scalar: " << mismatches << std::endl;
+    }
+}
+
+
+void benchFixedPoint()
+{
+    const int n = 1024;
+    for(size_t layout = 0; layout < std::size(exampleLayouts); layout++)
+    {
+        auto map = scaleLayout(exampleLayouts[layout], n);
+        auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+        world->setWorldInfo(map, n, n);
+
+        rcc::RayCastable viewer(60.0f, 0.0f, 1920);
+        viewer.pos = rcc::Vector{ 1.5f * n / 8 * 64, 1.5f * n / 8 * 64 };
+        const size_t rays = viewer.getRayBuffer().size();
+
+        const std::string name = "layout " + std::to_string(layout) + " " + std::to_string(n) + "^2";
+        const int frames = 36;
+        double t = measure([&]() {
+            for(int f = 0; f < frames; f++) {
+                viewer.rotation = f * 10.0f;
+                viewer.castRayAs<float>(*world, 0, rays);
+            }
+        });
+        report("float", name, rays * frames / t, "rays/s");
+
+        t = measure([&]() {
+            for(int f = 0; f < frames; f++) {
+                viewer.rotation = f * 10.0f;
+                viewer.castRayAs<rcc::Fixed>(*world, 0, rays);
+            }
+        });
+        report("fixed 16.16", name, rays * frames / t, "rays/s");
+    }
+}
+
+
+/// @brief Build an n*n arena, walled in, with a few scattered pillars
+std::vector<int> makeArena(int n, float density, unsigned seed = 5)
+{
+    auto map = makeEscapeMap(n, density, seed);
+    for(int i = 0; i < n; i++)
+        map[i] = map[(n - 1) * n + i] = map[i * n] = map[i * n + n - 1] = 1;
+    return map;
+}
+
+
+/// @brief Build an n*n perfect maze of one tile wide corridors, n odd
+std::vector<int> makeMaze(int n, unsigned seed = 8)
+{
+    std::mt19937 gen(seed);
+    std::vector<int> map(n * n, 1);
+    std::vector<std::pair<int, int>> stack{ { 1, 1 } };
+    map[n + 1] = 0;
+    while (!stack.empty())
+    {
+        auto [x, y] = stack.back();
+        std::pair<int, int> next[4];
+        int count = 0;
+        for(auto [dx, dy]: { std::pair{ 2, 0 }, { -2, 0 }, { 0, 2 }, { 0, -2 } })
+            if(x + dx > 0 && x + dx < n - 1 && y + dy > 0 && y + dy < n - 1 && map[(y + dy) * n + x + dx])
+                next[count++] = { dx, dy };
+
+        if(count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        auto [dx, dy] = next[gen() % count];
+        map[(y + dy / 2) * n + x + dx / 2] = 0;
+        map[(y + dy) * n + x + dx] = 0;
+        stack.push_back({ x + dx, y + dy });
+    }
+    return map;
+}
+
+
+void benchAcceleration()
+{
+    struct Level
+    {
+        std::string name;
+        std::vector<int> map;
+        int n;
+    };
+    const Level levels[] = {
+        { "open 2048^2", makeArena(2048, 0.0005f), 2048 },
+        { "rooms 1024^2", scaleLayout(exampleLayouts[0], 1024), 1024 },
+        { "maze 1023^2", makeMaze(1023), 1023 },
+    };
+    const std::pair<rcc::Acceleration, std::string> modes[] = {
+        { rcc::Acceleration::None, "cell walk" },
+        { rcc::Acceleration::Pyramid, "pyramid" },
+        { rcc::Acceleration::DistanceField, "dist field" },
+    };
+
+    for(const Level& level: levels)
+    {
+        auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+        world->setWorldInfo(level.map, level.n, level.n);
+
+        // centre of a cell that is empty in both levels
+        rcc::RayCastable viewer(60.0f, 0.0f, 1920);
+        viewer.pos = rcc::Vector{ 1.5f * level.n / 8 * 64, 1.5f * level.n / 8 * 64 };
+
+        for(const auto& [mode, modeName]: modes)
+        {
+            const auto t0 = Clock::now();
+            world->setAcceleration(mode);
+            const double build = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+            const int frames = 36;
+            double t = measure([&]() {
+                for(int f = 0; f < frames; f++) {
+                    viewer.rotation = f * 10.0f;
+                    viewer.castRay(*world);
+                }
+            });
+            report(modeName, level.name, viewer.getRayBuffer().size() * frames / t, "rays/s");
+            std::cout << "  built in " << std::setprecision(1) << build << " ms" << std::endl;
+        }
+    }
+}
+
+
+void benchLargeMap()
+{
+    // traversal reads one bit per tile: 2 MB at 4096^2 where the ids take 64 MB
+    const int n = 4096;
+    auto map = makeArena(n, 0.0005f);
+    auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+    world->setWorldInfo(map, n, n);
+
+    rcc::RayCastable viewer(60.0f, 0.0f, 1920);
+    viewer.pos = rcc::Vector{ (n / 2 + 0.5f) * 64, (n / 2 + 0.5f) * 64 };
+
+    const int frames = 36;
+    double t = measure([&]() {
+        for(int f = 0; f < frames; f++) {
+            viewer.rotation = f * 10.0f;
+            viewer.castRay(*world);
+        }
+    });
+    report("castRay", "arena 4096^2", viewer.getRayBuffer().size() * frames / t, "rays/s");
+}
+
+
+void benchMapLayouts()
+{
+    // an 8 MB bitmap, too big for the cache, so every new line a ray touches
+    // shows. Narrow views looking one way at a time, from spots spread over
+    // the map so no frame finds the lines of the one before
+    const int n = 8192;
+    auto map = makeArena(n, 0.0005f);
+    auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+    world->setWorldInfo(map, n, n);
+
+    const std::pair<rcc::MapLayout, std::string> layouts[] = {
+        { rcc::MapLayout::RowMajor, "row major" },
+        { rcc::MapLayout::Tiled, "tiled 8x8" },
+        { rcc::MapLayout::Morton, "morton 8x8" },
+    };
+    const std::pair<float, std::string> headings[] = {
+        { 0.0f, "along rows" },
+        { 45.0f, "diagonal" },
+        { 90.0f, "along columns" },
+    };
+
+    std::mt19937 gen(9);
+    std::uniform_real_distribution<float> spot(n / 4 * 64.0f, 3 * n / 4 * 64.0f);
+    std::vector<rcc::Vector> spots(16);
+    for(auto& p: spots) p = rcc::Vector{ spot(gen), spot(gen) };
+
+    for(const auto& [layout, layoutName]: layouts)
+    {
+        world->setMapLayout(layout);
+        for(const auto& [heading, headingName]: headings)
+        {
+            rcc::RayCastable viewer(10.0f, heading, 1920);
+            double t = measure([&]() {
+                for(const auto& p: spots) {
+                    viewer.pos = p;
+                    viewer.castRay(*world);
+                }
+            });
+            report(layoutName, headingName, viewer.getRayBuffer().size() * spots.size() / t, "rays/s");
+        }
+    }
+}
+
+
+void benchMapFile()
+{
+    // the same 4096^2 level parsed from CSV text, the way literal maps load
+    // today, and mapped from a map file. The file is in the page cache after
+    // the first repetition, as a level reopened from disk usually is
+    const int n = 4096;
+    auto map = makeArena(n, 0.01f);
+    std::ostringstream csv;
+    for(int y = 0; y < n; y++)
+        for(int x = 0; x < n; x++)
+            csv << map[y * n + x] << (x + 1 < n ? ',' : '\n');
+    const std::string text = csv.str();
+    const std::string path = (std::filesystem::temp_directory_path() / "rcc_bench_map.rccm").string();
+    rcc::writeMapFile(path.c_str(), map, n, n);
+
+    auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+    std::vector<int> ids;
+    double t = measure([&]() {
+        unsigned cols = 0, rows = 0;
+        rcc::readMapText(text, ids, cols, rows);
+        world->setWorldInfo(ids, cols, rows);
+    });
+    report("load", "csv 4096^2", 1 / t, "loads/s");
+
+    rcc::MapFile file;
+    t = measure([&]() {
+        file.open(path.c_str());
+        file.applyTo(*world);
+    });
+    report("load", "map file 4096^2", 1 / t, "loads/s");
+    file.close();
+    std::remove(path.c_str());
+}
+
+
+void benchStreaming()
+{
+    // a generated 65536^2 world, 16 GB of ids, walked through on a budget of
+    // 16 chunks (4 MB). A frame is the streamer update plus the cast, and
+    // never waits on a chunk
+    const int n = 65536;
+    rcc::GeneratedChunkSource source([](int y, int x) {
+        std::uint32_t h = std::uint32_t(x) * 0x9e3779b1u ^ std::uint32_t(y) * 0x85ebca77u;
+        h ^= h >> 15;
+        h *= 0x2c1b3c6du;
+        h ^= h >> 12;
+        return h % 100 == 0 ? 1 : 0;
+    });
+    auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+    rcc::RayCastable player(60.0f, 0.0f, 1920);
+    player.pos = rcc::Vector{ 1000.5f * 64, 30000.5f * 64 };
+    world->setPlayer(player);
+    rcc::ChunkStreamer streamer(source, n, n, 16, 1);
+    streamer.attach(*world);
+    streamer.flush(*world);
+
+    const int frames = 600;
+    double total = 0.0, worst = 0.0;
+    size_t unloaded = 0;
+    for(int f = 0; f < frames; f++)
+    {
+        player.pos.x += 4 * 64;     // a chunk every 64 frames
+        const auto t0 = Clock::now();
+        streamer.update(*world);
+        world->update(0.0f);
+        const double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        total += s;
+        worst = std::max(worst, s);
+        for(int id: player.getRayBuffer().tileId) unloaded += id == rcc::World::unloadedTile;
+    }
+    report("streaming", "65536^2, 16 chunk budget", frames / total, "frames/s");
+    std::cout << "  worst frame " << std::setprecision(2) << worst * 1000 << " ms, "
+              << streamer.getLoadCount() << " chunks loaded, " << streamer.getResidentCount() << " resident, "
+              << std::setprecision(3) << 100.0 * unloaded / (frames * player.getRayBuffer().size()) << "% of rays hit unloaded chunks" << std::endl;
+}
+
+
+void benchSprites()
+{
+    // 1000 tile sized sprites scattered over a walled 128^2 level, seen from its centre.
+    // The naive pass tests every column of every sprite in front of the
+    // viewer and std::sorts what is left
+    const int n = 128;
+    auto map = makeArena(n, 0.03f);
+    map[(n / 2) * n + n / 2] = 0;
+    auto world = rcc::createWorld(64, rcc::Vector{ 1920, 1080 });
+    world->setWorldInfo(map, n, n);
+
+    rcc::RayCastable viewer(60.0f, 0.0f, 1920, rcc::Projection::CameraPlane);
+    viewer.pos = rcc::Vector{ (n / 2 + 0.5f) * 64, (n / 2 + 0.5f) * 64 };
+    viewer.castRay(*world);
+
+    std::mt19937 gen(10);
+    std::uniform_real_distribution<float> spot(64.0f, (n - 1) * 64.0f);
+    std::vector<rcc::Sprite> sprites(1000);
+    for(auto& sprite: sprites) sprite = { rcc::Vector{ spot(gen), spot(gen) }, 64.0f };
+
+    const int frames = 100;
+    const auto& dist = viewer.getRayBuffer().dist;
+    const rcc::Vector view = rcc::Vector::fromAngle(rcc::degToRad(viewer.rotation));
+    std::vector<rcc::SpriteSpan> visible;
+    double t = measure([&]() {
+        for(int f = 0; f < frames; f++)
+        {
+            visible.clear();
+            for(size_t i = 0; i < sprites.size(); i++)
+            {
+                const rcc::Vector rel = sprites[i].pos - viewer.pos;
+                const float d = rel.dotProduct(view);
+                if(d < 1.0f) continue;
+                const float side = rel.x * -view.y + rel.y * view.x;
+                const float left = viewer.projectToColumn(side - sprites[i].size * 0.5f, d);
+                const float right = viewer.projectToColumn(side + sprites[i].size * 0.5f, d);
+                int first = -1, last = -1;
+                for(int x = std::max(int(std::ceil(left)), 0); x < std::min(int(std::ceil(right)), int(dist.size())); x++)
+                    if(dist[x] > d) {
+                        if(first < 0) first = x;
+                        last = x + 1;
+                    }
+                if(first >= 0) visible.push_back({ i, d, left, right - left, first, last });
+            }
+            std::sort(visible.begin(), visible.end(), [](const auto& a, const auto& b) { return a.depth > b.depth; });
+        }
+        sink = sink + visible.size();
+    });
+    report("sprites", "per column, std::sort", frames / t, "frames/s");
+
+    rcc::DepthBuffer depth;
+    t = measure([&]() {
+        for(int f = 0; f < frames; f++)
+        {
+            depth.build(viewer.getRayBuffer());
+            rcc::cullSprites(viewer, depth, sprites, visible);
+        }
+        sink = sink + visible.size();
+    });
+    report("sprites", "depth runs, radix sort", frames / t, "frames/s");
+    std::cout << "  " << visible.size() << " of " << sprites.size() << " sprites visible" << std::endl;
+}
+
+
+int main(int argc, char const *argv[])
+{
+    benchMapLookup();
+    benchEscapingRays();
+    benchParallelUpdate();
+    benchIncrementalUpdate();
+    benchTurnInPlace();
+    benchPacketCasting();
+    benchFixedPoint();
+    benchAcceleration();
+    benchLargeMap();
+    benchMapLayouts();
+    benchMapFile();
+    benchStreaming();
+    benchSprites();
+    return 0;
+}
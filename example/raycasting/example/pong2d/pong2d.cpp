@@ -14,6 +14,7 @@
 #include <random>
 
 #include <SDL3/SDL.h>
+#include <dl2hub/circle.h>
 #include <emscripten/emscripten.h>
 
 
@@ -61,7 +62,7 @@ bool onExit();
 void onReset();
 void onRestart();
 void onGameOver();
-void drawFilledCircle(SDL_Renderer* renderer, const float& x, const float& y, const float& radius);
+dl2hub::CircleCache circles;
 void mainLoop();
 
 float randRange(float min, float max);
@@ -181,7 +182,7 @@ bool onDraw() {
     SDL_RenderLine(renderer, W * 0.5f, 0.0f, W * 0.5f, H);
 
     SDL_SetRenderDrawColor(renderer, 0x34, 0x54, 0xf2, 0xff);
-    drawFilledCircle(renderer, ball.x, ball.y, BALL_DIAM / 2);
+    circles.draw(renderer, ball.x, ball.y, BALL_DIAM / 2);
 
     Player::drawRect.x = opponent.position.x;
     Player::drawRect.y = opponent.position.y;
@@ -322,6 +323,7 @@ bool onCreate() {
 
 
 bool onExit() {
+    circles.clear();
     SDL_DestroyWindow(window);
     SDL_Quit();
     std::cout << std::flush;    // incase there is something hanging on the stdout buffer
@@ -329,36 +331,6 @@ bool onExit() {
 }
 
 
-void drawFilledCircle(SDL_Renderer* renderer, const float& px, const float& py, const float& radius)
-{
-    auto drawHorizontalLine = [](SDL_Renderer* renderer, int x1, int x2, int y) -> void {
-        for(int x = x1; x <= x2; x++)
-            SDL_RenderPoint(renderer, x, y);
-    };
-
-    int x = 0;
-    int y = radius;
-    int d = 3 - (int(radius) << 1);
-
-    while (y >= x)
-    {
-        drawHorizontalLine(renderer, px - x, px + x, py - y);
-        drawHorizontalLine(renderer, px - x, px + x, py + y);
-        drawHorizontalLine(renderer, px - y, px + y, py - x);
-        drawHorizontalLine(renderer, px - y, px + y, py + x);
-
-        if(d < 0) 
-            d = d + (x << 2) + 6;
-        else {
-            d = d + ((x - y) << 2) + 10;
-            y--;
-        }
-        x++;
-    }
-    
-}
-
-
 bool init(const char* title, int w, int h) {
     if(SDL_Init(SDL_INIT_VIDEO) != 0) return false;
     std::cout << "SDL3 initialized\n";
@@ -8,6 +8,8 @@
 #include <vector>
 #include <cmath>
 #include <SDL3/SDL.h>
+#include <dl2hub/circle.h>
+#include <dl2hub/fixed_timestep.h>
 #include <emscripten/emscripten.h>
 
 using Map_t = std::vector<short>;
@@ -16,8 +18,9 @@ template<typename T>
 T getMapId(const Map_t& map, const T& y, const T& x);
 
 float degToRad(float f);
+void update(float dt);
 
-void drawFilledCircle(SDL_Renderer* renderer, const float& x, const float& y, const float& radius);
+dl2hub::CircleCache circles;
 
 const short TILESIZE = 64;
 const short TILE_COL = 8;
@@ -52,6 +55,7 @@ std::vector<Castable> characters;
 
 bool shouldQuit = false;
 SDL_Event evt;
+dl2hub::FixedTimestep timestep;
 
 Map_t levelMap {
     1,1,1,1,1,1,1,1,
@@ -71,6 +75,10 @@ void init()
     player.pos.y = 80;
     player.fov = 60;
     player.rotation = 0.0f;
+
+    // the first advance() of the timestep runs no update, cast once so the
+    // first frame has rays to draw
+    update(0.0f);
 }
 
 
@@ -186,7 +194,7 @@ void render(SDL_Renderer* renderer)
     }
 
     SDL_SetRenderDrawColor(renderer, 0x32, 0x54, 0xa4, 0xff);
-    drawFilledCircle(renderer, player.pos.x, player.pos.y, 4);
+    circles.draw(renderer, player.pos.x, player.pos.y, 4);
 
 }
 
@@ -232,11 +240,11 @@ void gameLoop()
 {
     while (SDL_PollEvent(&evt))
         processEvent(evt, shouldQuit);
+    timestep.advance(update);
     
     SDL_SetRenderDrawColor(canvas.renderer, 0x00, 0x00, 0x00, 0x00);
     SDL_RenderClear(canvas.renderer);
     render(canvas.renderer);
-    update(1/60);
     SDL_RenderPresent(canvas.renderer);
 }
 
@@ -280,6 +288,7 @@ int main(int argc, char const *argv[])
     init();
     mainLoop();
 
+    circles.clear();
     SDL_DestroyWindow(canvas.window);
     SDL_Quit();
 
@@ -290,45 +299,10 @@ int main(int argc, char const *argv[])
 template<typename T>
 T getMapId(const Map_t &map, const T&y, const T&x)
 {
-    T res;
-    T index = y * TILE_COL + x;
-    if(index >= map.size()) return -1;
-    try {
-        res = map.at(index);
-    } catch(...) {
-        res = -1;
-    }
-    return res;
-}
-
-
-void drawFilledCircle(SDL_Renderer* renderer, const float& px, const float& py, const float& radius)
-{
-    auto drawHorizontalLine = [](SDL_Renderer* renderer, int x1, int x2, int y) -> void {
-        for(int x = x1; x <= x2; x++)
-            SDL_RenderPoint(renderer, x, y);
-    };
-
-    int x = 0;
-    int y = radius;
-    int d = 3 - (int(radius) << 1);
-
-    while (y >= x)
-    {
-        drawHorizontalLine(renderer, px - x, px + x, py - y);
-        drawHorizontalLine(renderer, px - x, px + x, py + y);
-        drawHorizontalLine(renderer, px - y, px + y, py - x);
-        drawHorizontalLine(renderer, px - y, px + y, py + x);
-
-        if(d < 0) 
-            d = d + (x << 2) + 6;
-        else {
-            d = d + ((x - y) << 2) + 10;
-            y--;
-        }
-        x++;
-    }
-    
+    if(static_cast<unsigned>(x) >= static_cast<unsigned>(TILE_COL) ||
+       static_cast<unsigned>(y) >= static_cast<unsigned>(TILE_ROW))
+        return -1;
+    return map[y * TILE_COL + x];
 }
 
 
@@ -15,6 +15,40 @@
 #include <cmath>
 #include <numbers>
 #include <cassert>
+#include <limits>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <array>
+
+// Packet casting traces neighbouring rays in lockstep, one per SIMD lane.
+// The width follows the instruction sets the compiler targets; define
+// RCC_NO_SIMD to force the scalar path
+#if !defined(RCC_NO_SIMD) && defined(__AVX2__)
+    #include <immintrin.h>
+    #define RCC_PACKET_WIDTH 8
+#elif !defined(RCC_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define RCC_PACKET_WIDTH 4
+#else
+    #define RCC_PACKET_WIDTH 1
+#endif
+
+// Hooks for timing the casting stage and naming the worker threads, e.g.
+// define them to DL2HUB_PROFILE_SCOPE and DL2HUB_TRACE_THREAD_NAME before
+// including this header. They compile to nothing otherwise
+#ifndef RCC_PROFILE_SCOPE
+    #define RCC_PROFILE_SCOPE(name)
+#endif
+#ifndef RCC_THREAD_NAME
+    #define RCC_THREAD_NAME(name)
+#endif
 
 
 namespace rcc
@@ -23,6 +57,7 @@ namespace rcc
     class World;
     class Vector;
     class RayCastable;
+    class WorkerPool;
 
     using WorldPtr = std::unique_ptr<World>;
 
@@ -76,40 +111,167 @@ namespace rcc
     };
 
 
+    /// A 16.16 fixed point number, the scalar of the integer only traversal.
+    /// Conversions, * and / clamp to the range, + and - wrap like plain ints so
+    /// the traversal loop stays a single integer add per step
+    struct Fixed
+    {
+        static constexpr int fracBits = 16;
+        std::int32_t raw = 0;
+
+        Fixed() = default;
+        explicit Fixed(float f);
+        explicit operator float() const;
+
+        /// @brief Build a number from its raw representation, clamped to the range
+        static Fixed fromRaw(std::int64_t raw);
+
+        Fixed operator+(const Fixed& f) const;
+        Fixed operator-(const Fixed& f) const;
+        Fixed operator*(const Fixed& f) const;
+        Fixed operator/(const Fixed& f) const;
+        Fixed& operator+=(const Fixed& f);
+
+        bool operator<(const Fixed& f) const;
+        bool operator==(const Fixed& f) const;
+    };
+
+    Fixed abs(const Fixed& f);
+
+    /// @brief Round down to an integer, for float and Fixed alike
+    int floorToInt(float f);
+    int floorToInt(const Fixed& f);
+
+    /// The largest tDelta, also used for a ray that never crosses a grid line
+    /// of an axis. For Fixed it is 2^14 tiles, half the range, so tMax + tDelta
+    /// cannot wrap before a ray leaves any map under 2^14 tiles a side
+    template<typename Scalar>
+    inline const Scalar farthest = std::numeric_limits<Scalar>::infinity();
+
+    template<>
+    inline const Fixed farthest<Fixed> = Fixed::fromRaw(std::int64_t(1) << 30);
+
+    // Define RCC_FIXED_POINT to trace rays in 16.16 fixed point instead of
+    // float. The traversal loop then only adds and compares integers, which
+    // avoids float to int conversions where they are slow, such as wasm
+#ifdef RCC_FIXED_POINT
+    using TraversalScalar = Fixed;
+#else
+    using TraversalScalar = float;
+#endif
+
+
     struct Ray
     {
         float angle = 0.0f; // in degrees
         float dist = 0.0f;
         int tileSize = 0.0f;
         bool isVert = false;
-        Vector start, end, dir, xIntercept, yIntercept;
+        Vector start, end, dir;
 
         public:
             Ray(const float& angle);
     };
 
 
+    /// Cast results of a RayCastable as one contiguous array per field, indexed
+    /// by ray. Column renderers that only need dist and isVert stream just
+    /// those arrays instead of whole Ray structs
+    struct RayBuffer
+    {
+        std::vector<float> angle;   // offset from the view direction, in degrees
+        std::vector<float> dist;    // fisheye corrected distance to the hit
+        std::vector<float> hitX;    // hit point in world space
+        std::vector<float> hitY;
+        std::vector<int> cellX;     // map cell that stopped the ray
+        std::vector<int> cellY;
+        std::vector<int> tileId;    // map id of that cell
+        std::vector<float> wallX;   // where along the wall face the ray hit, in [0, 1)
+
+        // not std::vector<bool>: packed bits would make neighbouring rays share
+        // a byte, which breaks casting slices of the view on separate threads
+        std::vector<unsigned char> isVert;
+
+        size_t size() const;
+
+        void resize(size_t count);
+    };
+
+
+    /// How the rays of a RayCastable are spread over its field of view
+    enum class Projection
+    {
+        Angular,        // equal angles between rays, dist is corrected by cos(offset)
+        CameraPlane,    // rays through equally spaced columns of a flat camera
+                        // plane, dist is the perpendicular distance as is
+    };
+
+
+    /// How a traversal gets across empty parts of the map
+    enum class Acceleration
+    {
+        None,           // visit every cell the ray crosses
+        Pyramid,        // step over whole empty blocks of an occupancy mip pyramid
+        DistanceField,  // leap across the empty square a Chebyshev distance
+                        // field guarantees around every cell
+    };
+
+
+    /// How World lays out the occupancy bitmap traversal reads. Every layout
+    /// pads to powers of two, so finding a tile's bit is shifts and masks
+    enum class MapLayout
+    {
+        RowMajor,   // rows of bits, one after the other
+        Tiled,      // one 64 bit word per 8x8 block of tiles, blocks row by row
+        Morton,     // 8x8 blocks as in Tiled, ordered along a Z curve
+        Chunked,    // a bitmap per MapChunk, only while World::setStreamedMap() is in use
+    };
+
+
+    /// The tiles of one chunk of a streamed map, see World::setStreamedMap().
+    /// The map is cut into squares of size tiles on multiples of size, the
+    /// parts of edge chunks past the map are never read
+    struct MapChunk
+    {
+        static constexpr int shift = 8;
+        static constexpr int size = 1 << shift;
+
+        std::uint64_t occupancy[size * size / 64];  // one bit per tile, size / 64 words a row
+        int ids[size * size];                       // row by row
+
+        /// @brief Set the occupancy bits from the ids
+        void buildOccupancy();
+    };
+
+
     /// This is the class for all entities that can cast a ray
     class RayCastable
     {
         private:
             float rayInc = 0.0f;        // incrementation steps between rays
-            float fov = 60.0f;          // in degrees
-            std::vector<Ray> rays;
-
-            /// @brief Cast rays and check for horizontal intersection with blocks
-            /// @param world is the current world
-            /// @return a Vector for the overlapped distance before intersection
-            /// A ray can take any combination of isLeft and isRight
-            /// @todo make blocks customizable: for now a block B is B != 0
-            Vector getRayHorizontalIntercept(const float &angleInRadian, const World& world) const;
 
-            /// @brief Cast rays and check for vertical intersection with blocks
-            /// @param world is the current world
-            /// @return a Vector for the overlapped distance before intersection
-            /// A ray can take any combination of isLeft and isRight
-            /// @todo make blocks customizable: for now a block B is B != 0
-            Vector getRayVerticalIntercept(const float &angleInRadian, const World& world) const;
+            // how far off a whole number of columns a turn may be for its rays to
+            // be reused, and how far a view may turn before it is cast again
+            static constexpr float columnTolerance = 1e-3f;
+            float fov = 60.0f;          // in degrees
+            Projection projection = Projection::Angular;
+            float planeScale = 0.0f;    // CameraPlane columns per unit of side / depth
+            RayBuffer rayBuffer;
+            std::vector<Ray> rays;      // compatibility view, see getRays()
+
+            // cos/sin of every ray's offset from the view direction, fixed at
+            // construction. A ray direction is the view direction rotated by its
+            // offset, and offsetCos doubles as the fisheye correction
+            std::vector<float> offsetCos;
+            std::vector<float> offsetSin;
+
+            // the pose and map generation of the last cast World::update() did,
+            // it skips the castable while all three are unchanged
+            friend class World;
+            Vector castPos;
+            float castRotation = 0.0f;
+            unsigned castGeneration = 0;
+            bool hasCast = false;
 
         public:
             Vector pos;
@@ -121,11 +283,127 @@ namespace rcc
             /// @param fov is the field of view of the character in degrees
             /// @param rotation is the rotation of the character in degrees
             /// @param fovDiv is the amount that the field of view should be divided into
-            RayCastable(float fov, float rotation, int fovDiv = 3);
-
+            /// @param projection is how the rays are spread over the field of view
+            RayCastable(float fov, float rotation, int fovDiv = 3, Projection projection = Projection::Angular);
+
+            /// @brief Get the cast results as one array per field
+            const RayBuffer& getRayBuffer() const;
+
+            /// @brief Check whether the pose or the map changed since World::update()
+            /// last cast this castable, or it was never cast
+            /// @param world is the world the castable is updated in
+            bool isDirty(const World& world) const;
+
+            /// @brief Reuse the rays of a cast made from the same position at another
+            /// rotation. When the two views are a whole number of columns apart the
+            /// results are shifted over and only the newly exposed columns are left
+            /// to cast. Only Angular views have equal angles between columns
+            /// @param fromRotation is the rotation the current rays were cast at
+            /// @param first receives the first column that still has to be cast
+            /// @param last receives one past the last column that has to be cast
+            /// @param shiftedRotation receives the rotation the shifted rays line up
+            /// with, a whole number of columns from fromRotation
+            /// @return false if the rays cannot be reused or the turn is less than
+            /// a column, nothing is changed then
+            bool shiftRays(float fromRotation, size_t& first, size_t& last, float& shiftedRotation);
+
+            /// @brief Get the cast results as Ray structs. The vector is rebuilt
+            /// from the ray buffer on every call, prefer getRayBuffer() in code
+            /// that runs every frame
             std::vector<Ray>& getRays();
 
             void castRay(const World& world);
+
+            /// @brief Cast only the rays in [first, last), so a view can be split
+            /// across threads. Each ray writes only its own slot in the ray buffer
+            /// @param world is the current world
+            /// @param first is the index of the first ray to cast
+            /// @param last is one past the index of the last ray to cast
+            void castRay(const World& world, size_t first, size_t last);
+
+            /// @brief castRay with the grid traversal done in a given scalar type.
+            /// castRay uses TraversalScalar, other types are there to compare against
+            /// @param world is the current world
+            /// @param first is the index of the first ray to cast
+            /// @param last is one past the index of the last ray to cast
+            template<typename Scalar>
+            void castRayAs(const World& world, size_t first, size_t last);
+
+            /// @brief Cast the rays in [first, last) RCC_PACKET_WIDTH at a time,
+            /// stepping every lane of a packet together until all lanes hit.
+            /// Gives the same hit cells as castRayAs<float>, which it falls back to
+            /// for the rays left over at the end and when built without SIMD
+            /// @param world is the current world
+            /// @param first is the index of the first ray to cast
+            /// @param last is one past the index of the last ray to cast
+            void castRayPackets(const World& world, size_t first, size_t last);
+
+            /// @brief Find where a point lands in the view, the inverse of how rays
+            /// are spread over the field of view
+            /// @param point is a position in world space
+            /// @param depth receives the distance of the point along the view
+            /// direction, comparable with RayBuffer::dist
+            /// @return the column of the point, ray i is at column i. Only meaningful
+            /// for a positive depth
+            float projectToColumn(const Vector& point, float& depth) const;
+
+            /// @brief projectToColumn for a point already in view space, so callers
+            /// projecting many points can compute the view direction once
+            /// @param side is the distance of the point to the right of the view direction
+            /// @param depth is the distance of the point along the view direction, positive
+            float projectToColumn(float side, float depth) const;
+
+        private:
+            Vector getRayDir(size_t i, const Vector& view) const;
+
+            // castRayAs with the occupancy lookups specialized for one layout
+            template<typename Scalar, MapLayout Layout>
+            void traceRays(const World& world, size_t first, size_t last);
+
+            // castRayPackets with the occupancy lookups specialized for one layout
+            template<MapLayout Layout>
+            void tracePackets(const World& world, size_t first, size_t last);
+
+            void setHit(size_t i, const Vector& dir, float t, float tileSize, bool isVert, int tx, int ty, int id);
+    };
+
+
+    /// A fixed set of worker threads that run batches of independent tasks.
+    /// The calling thread takes part in every batch, so a pool of n workers
+    /// runs a batch on n + 1 threads
+    class WorkerPool
+    {
+        public:
+            /// @param workerCount is the number of threads to spawn, 0 runs every
+            /// batch on the calling thread
+            explicit WorkerPool(unsigned workerCount);
+            ~WorkerPool();
+
+            WorkerPool(const WorkerPool&) = delete;
+            WorkerPool& operator=(const WorkerPool&) = delete;
+
+            /// @brief Run task(i) for every i in [0, count) and wait for all of them
+            /// @param count is the number of tasks in the batch
+            /// @param task is the work for a single index
+            void run(size_t count, const std::function<void(size_t)>& task);
+
+            unsigned getWorkerCount() const;
+
+        private:
+            void workerLoop();
+            void drain();
+
+            std::vector<std::thread> workers;
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable done;
+
+            const std::function<void(size_t)>* task = nullptr;
+            size_t taskCount = 0;
+            std::atomic<size_t> nextTask{ 0 };
+            unsigned generation = 0;    // bumped once per batch
+            unsigned activeWorkers = 0; // workers still inside the current batch
+            bool stopping = false;
     };
 
 
@@ -152,25 +430,146 @@ namespace rcc
             std::vector<RayCastable>& getCastables();
 
             /// @brief Set basic info for the world
-            /// @param map is the 1-d tilemap for the world
+            /// @param map is the 1-d tilemap for the world, it is read in place and
+            /// must not be resized while the world uses it
             /// @param col is the size of the column in the map
             /// @param row is the size of the row in the map
             void setWorldInfo(const std::vector<int>& map, const unsigned& col, const unsigned& row);
+
+            /// @brief Set basic info for the world from tiles the world does not own,
+            /// such as a mapped map file. Neither array is copied, both have to
+            /// outlive the world or the next setWorldInfo()
+            /// @param map is col * row tile ids, row by row
+            /// @param col is the size of the column in the map
+            /// @param row is the size of the row in the map
+            /// @param occupancy is an optional MapLayout::RowMajor bitmap of the map, as
+            /// getOccupancy() gives it. It is read in place until the layout or the
+            /// map changes, otherwise the bitmap is built from the ids
+            void setWorldInfo(const int* map, const unsigned& col, const unsigned& row, const std::uint64_t* occupancy = nullptr);
+
+            /// @brief Set a map held as a table of chunks, of which only some have to
+            /// be in memory. A null entry is a chunk that is not resident: rays
+            /// stop in its first cell with the id unloadedTile instead of waiting
+            /// for it. No acceleration structures are built, and whoever changes
+            /// entries calls markMapChanged(). See ChunkStreamer in rcc_stream.h
+            /// @param chunks is one entry per chunk, row by row, read in place
+            /// @param col is the size of the column in the map
+            /// @param row is the size of the row in the map
+            void setStreamedMap(const MapChunk* const* chunks, const unsigned& col, const unsigned& row);
+
+            /// The id getMapId() gives for cells of chunks that are not resident
+            static constexpr int unloadedTile = -2;
             
             /// @brief Set the player for this world
             /// @param player is a pointer to the player
             void setPlayer(RayCastable& player);
 
+            /// @brief Get the player, nullptr until setPlayer() is called
+            RayCastable* getPlayer() const;
+
             const Vector& getSize() const;
 
+            /// @brief Get the tile id at a cell of the map
+            /// @param y is the row of the cell
+            /// @param x is the column of the cell
+            /// @return the tile id, or -1 if the cell is outside the map
             int getMapId(const int& y, const int& x) const;
 
+            /// @brief Check whether a cell stops rays, reading only the occupancy
+            /// bitmap. Traversal asks this for every cell and calls getMapId() just
+            /// for the cell it stops in
+            /// @param y is the row of the cell
+            /// @param x is the column of the cell
+            /// @return true for non zero tiles and cells outside the map
+            bool isSolid(const int& y, const int& x) const;
+
+            /// @brief isSolid for a bitmap known to be in Layout, so the index math
+            /// is resolved at compile time. Layout has to be getMapLayout()
+            template<MapLayout Layout>
+            bool isSolidIn(const int& y, const int& x) const;
+
+            /// @brief Choose how the occupancy bitmap is laid out, see MapLayout.
+            /// The bitmap is rebuilt, the ids are not touched. Chunked cannot be
+            /// chosen, it is what setStreamedMap() uses
+            void setMapLayout(MapLayout layout);
+
+            /// @brief Get the layout traversal reads, Chunked while the map is streamed
+            MapLayout getMapLayout() const;
+
+            /// @brief Get the occupancy bitmap in the current layout, getOccupancyWords()
+            /// words long
+            const std::uint64_t* getOccupancy() const;
+
+            /// @brief Get the length of the occupancy bitmap of a map in 64 bit words
+            /// @param layout is the layout of the bitmap
+            /// @param col is the size of the column in the map
+            /// @param row is the size of the row in the map
+            static size_t getOccupancyWords(MapLayout layout, int col, int row);
+
             const int& getRowSize() const;
 
             const int& getColSize() const;
 
             const int& getTileSize() const;
 
+            /// @brief Spread ray casting in update() across worker threads
+            /// @param count is the number of extra threads, 0 casts everything on
+            /// the calling thread
+            void setWorkerCount(unsigned count);
+
+            /// @brief Choose between RayCastable::castRayPackets and the scalar
+            /// RayCastable::castRay (the default) for update(), both give the same hits
+            void setPacketCasting(bool enabled);
+
+            /// @brief Choose how castRay gets across empty space, see Acceleration.
+            /// Every mode stops in the same cells up to float rounding at grid
+            /// corners. Packet casting always visits every cell
+            void setAcceleration(Acceleration mode);
+
+            Acceleration getAcceleration() const;
+
+            /// @brief Tell the world a single tile of its map changed. The occupancy
+            /// bitmap is patched in place. With the pyramid
+            /// only the blocks over that tile are rebuilt, the distance field is
+            /// recomputed in full
+            /// @param y is the row of the tile
+            /// @param x is the column of the tile
+            void markTileChanged(const int& y, const int& x);
+
+            /// @brief Get the level of the largest empty pyramid block around a cell,
+            /// the block at level l is 2^l tiles a side and aligned to that size
+            /// @param y is the row of the cell
+            /// @param x is the column of the cell
+            /// @param guess is the level to start looking from, the answer is the
+            /// same for any guess but is found faster near it
+            /// @return 0 if the cell is not in an empty block of 2x2 or larger
+            int getEmptyLevel(const int& y, const int& x, int guess = 0) const;
+
+            /// @brief Get the Chebyshev distance in tiles from a cell to the nearest
+            /// solid tile or the outside of the map, capped at 255. Every cell less
+            /// than that many tiles away along both axes is empty
+            /// @param y is the row of the cell
+            /// @param x is the column of the cell
+            /// @return 0 for solid cells, cells outside the map and while the
+            /// distance field is not selected
+            int getClearance(const int& y, const int& x) const;
+
+            /// @brief Tell the world the map it was given in setWorldInfo() changed,
+            /// so every castable is cast again on the next update()
+            void markMapChanged();
+
+            /// @brief Get the map generation, bumped by every setWorldInfo() and
+            /// markMapChanged()
+            unsigned getMapGeneration() const;
+
+            /// @brief Get how many castables the last update() skipped because
+            /// neither their pose nor the map had changed
+            size_t getSkippedCasts() const;
+
+            /// @brief Get how many castables the last update() only turned, so it
+            /// shifted their rays and cast just the newly exposed columns
+            size_t getShiftedCasts() const;
+
             void update(float dt);
 
         private:
@@ -179,8 +578,69 @@ namespace rcc
             int colSize = 0;
             int tileSize = 0;
             
-            const std::vector<int>* currMap = nullptr;
-            RayCastable* player;
+            const int* currMap = nullptr;
+            unsigned mapGeneration = 0;
+
+            // one bit per tile, set for non zero ids, rows padded to whole words.
+            // It is all traversal reads until a ray stops, 32 times less memory
+            // to walk than the ids themselves. occupancyBits points either into
+            // occupancy or at a bitmap passed to setWorldInfo()
+            std::vector<std::uint64_t> occupancy;
+            const std::uint64_t* occupancyBits = nullptr;
+            const std::uint64_t* givenOccupancy = nullptr;
+            MapLayout layout = MapLayout::RowMajor;
+            int occupancyShift = 0;     // log2 of the words per row of bits or blocks
+
+            // the word holding a tile's bit and the bit in it
+            template<MapLayout Layout>
+            std::pair<size_t, int> locateTile(int y, int x) const;
+
+            RayCastable* player = nullptr;
+
+            const MapChunk* const* chunks = nullptr;   // set while the map is streamed
+            int chunksX = 0;                            // chunks per row of chunks
+            size_t skippedCasts = 0;
+            size_t shiftedCasts = 0;
+
+            // occupancy mip pyramid, level 0 is one byte per tile and every cell
+            // of level l is the max of the 2x2 cells under it in level l - 1.
+            // Cells that reach past the map count as occupied, so no block
+            // jump ever leaves the map
+            struct OccupancyLevel
+            {
+                int width = 0;
+                int height = 0;
+                std::vector<unsigned char> cells;
+            };
+
+            Acceleration acceleration = Acceleration::None;
+            std::vector<OccupancyLevel> pyramid;
+            std::vector<unsigned char> clearance;   // distance field, per tile
+
+            void buildOccupancy();
+            void setOccupied(int y, int x, bool solid);
+            void buildAcceleration();
+            void buildPyramid();
+            void buildDistanceField();
+            void updatePyramidCell(size_t level, int y, int x);
+
+            // a slice of one castable's rays, the unit of work handed to the pool
+            struct CastJob
+            {
+                RayCastable* castable;
+                size_t first;
+                size_t last;
+            };
+
+            static constexpr size_t raysPerJob = 64;
+            std::unique_ptr<WorkerPool> pool;
+            bool packetCasting = false;
+            std::vector<CastJob> castJobs;
+            std::vector<CastJob> castRanges;    // what each castable needs cast this update
+
+            // the real rotations of the castables whose rays were shifted, they
+            // are cast at the rotation the shift lined up with and put back after
+            std::vector<std::pair<RayCastable*, float>> shiftedRotations;
     };
 
 
@@ -249,139 +709,602 @@ namespace rcc
     }
 
 
-    inline Ray::Ray(const float& angle)
+    inline Fixed::Fixed(float f)
     {
-        this->angle = angle;
+        // clamp first, converting an out of range float to an integer is undefined
+        const float range = float(std::numeric_limits<std::int32_t>::max() >> fracBits);
+        f = std::clamp(f, -range, range);
+        raw = static_cast<std::int32_t>(f * (1 << fracBits) + (f < 0.0f ? -0.5f : 0.5f));
     }
 
-    
-    inline Vector RayCastable::getRayHorizontalIntercept(const float &angleInRadian, const World& world) const
+    inline Fixed::operator float() const
     {
-        float dy, dx, hyp;
-        int id, tx, ty;
-        Vector dir = Vector::fromAngle(angleInRadian);
-        Vector currPos{ 0, 0 };
+        return raw * (1.0f / (1 << fracBits));
+    }
 
-        bool isLeft = dir.dotProduct(Vector{-1, 0}) >= 0.0f;
-        bool isUp = dir.dotProduct(Vector{0, -1}) >= 0.0f;
+    inline Fixed Fixed::fromRaw(std::int64_t raw)
+    {
+        Fixed f;
+        f.raw = static_cast<std::int32_t>(std::clamp<std::int64_t>(raw,
+            std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max()));
+        return f;
+    }
 
-        short isLeftScaled = isLeft ? -1 : 1;
-        short isUpScaled = isUp ? -1 : 1;
+    inline Fixed Fixed::operator+(const Fixed &f) const
+    {
+        // through unsigned, signed overflow is undefined
+        Fixed res;
+        res.raw = static_cast<std::int32_t>(static_cast<std::uint32_t>(raw) + static_cast<std::uint32_t>(f.raw));
+        return res;
+    }
 
-        float xOffset = pos.x - std::floor(pos.x / world.getTileSize()) * world.getTileSize();
+    inline Fixed Fixed::operator-(const Fixed &f) const
+    {
+        Fixed res;
+        res.raw = static_cast<std::int32_t>(static_cast<std::uint32_t>(raw) - static_cast<std::uint32_t>(f.raw));
+        return res;
+    }
 
-        auto moveAndCheckId = [&]() -> void {
-            currPos.y += dy * isUpScaled;
-            currPos.x += dx * isLeftScaled;
+    inline Fixed Fixed::operator*(const Fixed &f) const
+    {
+        return fromRaw((std::int64_t(raw) * f.raw) >> fracBits);
+    }
 
-            ty = std::floor((pos.y + currPos.y) / world.getTileSize());
-            if(isLeft)
-                tx = std::floor((pos.x + currPos.x) / world.getTileSize()) - 1;
-            else
-                tx = std::ceil((pos.x + currPos.x) / world.getTileSize());
-            id = world.getMapId(ty, tx);
-        };
+    inline Fixed Fixed::operator/(const Fixed &f) const
+    {
+        return fromRaw((std::int64_t(raw) << fracBits) / f.raw);
+    }
 
-        dx = isLeft ? xOffset: world.getTileSize() - xOffset;
-        dy = std::abs(dx * std::tan(angleInRadian));
-        assert(dy >= 0 && dx >= 0);
+    inline Fixed &Fixed::operator+=(const Fixed &f)
+    {
+        return *this = *this + f;
+    }
 
-        moveAndCheckId();
-        if(id == 0) {
-            dx = world.getTileSize();
-            dy = std::abs(dx * std::tan(angleInRadian));
-            while (id == 0)
-                moveAndCheckId();
-        }
-        return currPos;
+    inline bool Fixed::operator<(const Fixed &f) const
+    {
+        return raw < f.raw;
     }
 
-    
-    inline Vector RayCastable::getRayVerticalIntercept(const float &angleInRadian, const World &world) const
-    {
-        float dy, dx, hyp;
-        int id;
-        Vector dir = Vector::fromAngle(angleInRadian);
-        Vector currPos{ 0, 0 };
-        Vector currIndex{ 0, 0 };
-
-        bool isLeft = dir.dotProduct(Vector{-1, 0}) >= 0.0f;
-        bool isUp = dir.dotProduct(Vector{0, -1}) >= 0.0f;
-        short isLeftScaled = isLeft ? -1 : 1;
-        short isUpScaled = isUp ? -1 : 1;
-
-        float yOffset = pos.y - std::floor(pos.y / world.getTileSize()) * world.getTileSize();
-
-        const float angInDeg = std::abs(radToDeg(angleInRadian));
-        const bool angIsInfinite = angInDeg == 90 || angInDeg == 270;
-
-        auto moveAndCheckId = [&]() -> void {
-            currPos.y += dy * isUpScaled;
-            currPos.x += dx * isLeftScaled;
-
-            currIndex.x = std::floor((pos.x + currPos.x) / world.getTileSize());
-            if(isUp)
-                currIndex.y = std::floor((pos.y + currPos.y) / world.getTileSize()) - 1;
-            else
-                currIndex.y = std::ceil((pos.y + currPos.y) / world.getTileSize());
-            id = world.getMapId(currIndex.y, currIndex.x);
-        };
+    inline bool Fixed::operator==(const Fixed &f) const
+    {
+        return raw == f.raw;
+    }
 
-        dy = isUp? yOffset : world.getTileSize() - yOffset;
-        dx = std::abs(dy / std::tan(angleInRadian));
-        if(angIsInfinite) dx = 0;
-        assert(dy >= 0 && dx >= 0);
-
-        moveAndCheckId();
-        if(id == 0) {
-            dy = world.getTileSize();
-            dx = isUp? std::abs(dy / std::tan(angleInRadian)): std::abs(dy * std::tan(angleInRadian));
-            if(angIsInfinite) dx = 0;
-            while (id == 0)
-                moveAndCheckId();
-        }
+    inline Fixed abs(const Fixed &f)
+    {
+        return f.raw < 0 ? Fixed{} - f : f;
+    }
 
-        return currPos;
+    inline int floorToInt(float f)
+    {
+        return int(std::floor(f));
     }
 
-    inline RayCastable::RayCastable(float fov, float rotation, int fovDiv) 
+    inline int floorToInt(const Fixed &f)
+    {
+        return f.raw >> Fixed::fracBits;
+    }
+
+
+    inline Ray::Ray(const float& angle)
+    {
+        this->angle = angle;
+    }
+
+
+    inline size_t RayBuffer::size() const
+    {
+        return angle.size();
+    }
+
+    inline void RayBuffer::resize(size_t count)
+    {
+        angle.resize(count);
+        dist.resize(count);
+        hitX.resize(count);
+        hitY.resize(count);
+        cellX.resize(count);
+        cellY.resize(count);
+        tileId.resize(count);
+        wallX.resize(count);
+        isVert.resize(count);
+    }
+
+
+    inline RayCastable::RayCastable(float fov, float rotation, int fovDiv, Projection projection) 
     {
         rayInc = fov / fovDiv;
         const float fovHalf = fov / 2;
-        for(float i = -fovHalf; i < fovHalf; i += rayInc)
-            rays.push_back({ i });
+
+        // derive every ray from its index, accumulating rayInc drifts and makes
+        // the ray count differ from fovDiv
+        for(int i = 0; i < fovDiv; i++)
+            rayBuffer.angle.push_back(-fovHalf + i * rayInc);
         
         if(fovDiv == 1) {
-            rays.clear();
-            rays.push_back(rotation);
+            rayBuffer.angle.clear();
+            rayBuffer.angle.push_back(rotation);
+        }
+
+        rayBuffer.resize(rayBuffer.angle.size());
+
+        if(projection == Projection::CameraPlane && fovDiv > 1) {
+            // the plane sits one unit in front of the view and is 2 * tan(fov / 2)
+            // wide. Offset vectors (1, column) are not normalized, so the ray
+            // length up to a wall is already the perpendicular distance
+            const float planeHalf = std::tan(degToRad(fovHalf));
+            for(int i = 0; i < fovDiv; i++) {
+                const float column = (-1.0f + 2.0f * i / fovDiv) * planeHalf;
+                offsetCos.push_back(1.0f);
+                offsetSin.push_back(column);
+                rayBuffer.angle[i] = radToDeg(std::atan(column));
+            }
+            planeScale = fovDiv / (2 * planeHalf);
+        } else {
+            for(float angle: rayBuffer.angle) {
+                offsetCos.push_back(std::cos(degToRad(angle)));
+                offsetSin.push_back(std::sin(degToRad(angle)));
+            }
         }
 
         this->fov = fov;
+        this->projection = projection;
+    }
+
+
+    inline const RayBuffer &RayCastable::getRayBuffer() const
+    {
+        return rayBuffer;
     }
 
 
     inline std::vector<Ray> &RayCastable::getRays()
     {
+        rays.clear();
+        for(size_t i = 0; i < rayBuffer.size(); i++)
+        {
+            Ray& ray = rays.emplace_back(rayBuffer.angle[i]);
+            ray.dist = rayBuffer.dist[i];
+            ray.isVert = rayBuffer.isVert[i];
+            ray.start = pos;
+            ray.end = Vector{ rayBuffer.hitX[i], rayBuffer.hitY[i] };
+            ray.dir = getRayDir(i, Vector::fromAngle(degToRad(rotation)));
+        }
         return rays;
     }
 
+
+    inline bool RayCastable::isDirty(const World &world) const
+    {
+        if(!hasCast || castGeneration != world.getMapGeneration() || pos.x != castPos.x || pos.y != castPos.y)
+            return true;
+        if(rotation == castRotation) return false;
+
+        // shifted rays line up with a rotation a little off the real one, a
+        // turn that small is not cast again
+        return projection != Projection::Angular ||
+               std::abs(std::remainder(rotation - castRotation, 360.0f)) > columnTolerance * rayInc;
+    }
+
+
+    inline bool RayCastable::shiftRays(float fromRotation, size_t &first, size_t &last, float &shiftedRotation)
+    {
+        const size_t count = rayBuffer.size();
+        if(projection != Projection::Angular || count < 2) return false;
+
+        // the turn in columns, it has to land on a column to line the rays up
+        const float columns = std::remainder(rotation - fromRotation, 360.0f) / rayInc;
+        const float whole = std::round(columns);
+        if(whole == 0.0f || std::abs(columns - whole) > columnTolerance || std::abs(whole) >= count) return false;
+
+        // ray i now looks where ray i + k looked, hits do not depend on the
+        // column but the fisheye corrected distance does
+        const long k = long(whole);
+        auto shift = [&](auto& field) {
+            if(k > 0) std::copy(field.begin() + k, field.end(), field.begin());
+            else std::copy_backward(field.begin(), field.end() + k, field.end());
+        };
+        shift(rayBuffer.hitX);
+        shift(rayBuffer.hitY);
+        shift(rayBuffer.cellX);
+        shift(rayBuffer.cellY);
+        shift(rayBuffer.tileId);
+        shift(rayBuffer.wallX);
+        shift(rayBuffer.isVert);
+
+        shiftedRotation = fromRotation + whole * rayInc;
+        first = k > 0 ? count - k : 0;
+        last = k > 0 ? count : size_t(-k);
+        for(size_t i = 0; i < count; i++)
+            if(i < first || i >= last)
+                rayBuffer.dist[i] = offsetCos[i] * std::hypot(rayBuffer.hitX[i] - pos.x, rayBuffer.hitY[i] - pos.y);
+        return true;
+    }
+
+
+    inline float RayCastable::projectToColumn(const Vector &point, float &depth) const
+    {
+        const Vector view = Vector::fromAngle(degToRad(rotation));
+        const Vector rel = point - pos;
+        depth = rel.dotProduct(view);
+        return projectToColumn(rel.x * -view.y + rel.y * view.x, depth);
+    }
+
+    inline float RayCastable::projectToColumn(float side, float depth) const
+    {
+        if(projection == Projection::CameraPlane)
+            return side / depth * planeScale + rayBuffer.size() * 0.5f;
+        return (radToDeg(std::atan2(side, depth)) + fov / 2) / rayInc;
+    }
+
+
+    inline Vector RayCastable::getRayDir(size_t i, const Vector &view) const
+    {
+        return Vector{ view.x * offsetCos[i] - view.y * offsetSin[i], view.y * offsetCos[i] + view.x * offsetSin[i] };
+    }
+
     
     inline void RayCastable::castRay(const World &world)
     {
-        for(auto it = rays.begin(); it != rays.end(); it++)
+        castRay(world, 0, rayBuffer.size());
+    }
+
+
+    inline void RayCastable::castRay(const World &world, size_t first, size_t last)
+    {
+        castRayAs<TraversalScalar>(world, first, last);
+    }
+
+
+    template<typename Scalar>
+    inline void RayCastable::castRayAs(const World &world, size_t first, size_t last)
+    {
+        switch (world.getMapLayout())
+        {
+            case MapLayout::RowMajor: traceRays<Scalar, MapLayout::RowMajor>(world, first, last); break;
+            case MapLayout::Tiled: traceRays<Scalar, MapLayout::Tiled>(world, first, last); break;
+            case MapLayout::Morton: traceRays<Scalar, MapLayout::Morton>(world, first, last); break;
+            case MapLayout::Chunked: traceRays<Scalar, MapLayout::Chunked>(world, first, last); break;
+        }
+    }
+
+
+    template<typename Scalar, MapLayout Layout>
+    inline void RayCastable::traceRays(const World &world, size_t first, size_t last)
+    {
+        using std::abs;
+
+        // Traversal runs in tile space, so every grid line sits on an integer
+        const float tileSize = world.getTileSize();
+        const Vector origin = pos * (1.0f / tileSize);
+        const int originX = std::floor(origin.x);
+        const int originY = std::floor(origin.y);
+        const Scalar nearNegX(origin.x - originX), nearPosX(originX + 1 - origin.x);
+        const Scalar nearNegY(origin.y - originY), nearPosY(originY + 1 - origin.y);
+        const Scalar zero(0.0f), one(1.0f);
+        const Scalar inf = farthest<Scalar>;
+        const Vector view = Vector::fromAngle(degToRad(rotation));
+        const Acceleration acceleration = world.getAcceleration();
+
+        // from + by, kept at inf instead of running past it, Fixed would wrap
+        auto farther = [&](Scalar from, Scalar by) { return inf - from < by ? inf : from + by; };
+
+        for(size_t i = first; i < last; i++)
+        {
+            const Vector dir = getRayDir(i, view);
+            const Scalar dirX(dir.x), dirY(dir.y);
+
+            // Amanatides-Woo: tDelta is the ray length between two grid lines of
+            // an axis, tMax the ray length to the next grid line of that axis
+            const int stepX = dirX < zero ? -1 : 1;
+            const int stepY = dirY < zero ? -1 : 1;
+            const Scalar tDeltaX = dirX != zero ? std::min(abs(one / dirX), inf) : inf;
+            const Scalar tDeltaY = dirY != zero ? std::min(abs(one / dirY), inf) : inf;
+            Scalar tMaxX = dirX != zero ? (stepX < 0 ? nearNegX : nearPosX) * tDeltaX : inf;
+            Scalar tMaxY = dirY != zero ? (stepY < 0 ? nearNegY : nearPosY) * tDeltaY : inf;
+
+            int tx = originX, ty = originY;
+            Scalar t = zero;
+            bool isVert = false;
+            int level = 0;
+            do
+            {
+                // grid lines of each axis the ray can cross before it may leave
+                // the empty region around the cell
+                int crossX = 1, crossY = 1;
+                if(acceleration == Acceleration::Pyramid) {
+                    // consecutive blocks along a ray tend to be the same size
+                    level = world.getEmptyLevel(ty, tx, level);
+                    if(level > 0) {
+                        const int blockX = (tx >> level) << level, blockY = (ty >> level) << level;
+                        crossX = stepX > 0 ? blockX + (1 << level) - tx : tx - blockX + 1;
+                        crossY = stepY > 0 ? blockY + (1 << level) - ty : ty - blockY + 1;
+                    }
+                } else if(acceleration == Acceleration::DistanceField) {
+                    // the square of clearance - 1 cells around the cell is empty
+                    crossX = crossY = std::max(world.getClearance(ty, tx), 1);
+                }
+
+                if(crossX > 1 || crossY > 1) {
+                    // leave the empty region in one go: find which side the ray
+                    // exits through, then count the grid lines of the other axis it
+                    // crossed on the way, breaking ties the way single steps do
+                    const Scalar exitX = crossX > 1 ? farther(tMaxX, tDeltaX * Scalar(float(crossX - 1))) : tMaxX;
+                    const Scalar exitY = crossY > 1 ? farther(tMaxY, tDeltaY * Scalar(float(crossY - 1))) : tMaxY;
+
+                    if(exitX < exitY) {
+                        const int crossed = tMaxY < exitX || tMaxY == exitX ?
+                            std::min(floorToInt((exitX - tMaxY) / tDeltaY) + 1, crossY - 1) : 0;
+                        ty += stepY * crossed;
+                        if(crossed) tMaxY += tDeltaY * Scalar(float(crossed));
+                        tx += stepX * crossX;
+                        t = exitX;
+                        tMaxX = exitX + tDeltaX;
+                        isVert = false;
+                    } else {
+                        const int crossed = tMaxX < exitY ?
+                            std::min(floorToInt((exitY - tMaxX) / tDeltaX) + 1, crossX - 1) : 0;
+                        tx += stepX * crossed;
+                        if(crossed) tMaxX += tDeltaX * Scalar(float(crossed));
+                        ty += stepY * crossY;
+                        t = exitY;
+                        tMaxY = exitY + tDeltaY;
+                        isVert = true;
+                    }
+                } else if(tMaxX < tMaxY) {
+                    tx += stepX;
+                    t = tMaxX;
+                    tMaxX += tDeltaX;
+                    isVert = false;
+                } else {
+                    ty += stepY;
+                    t = tMaxY;
+                    tMaxY += tDeltaY;
+                    isVert = true;
+                }
+            } while (!world.isSolidIn<Layout>(ty, tx));
+
+            setHit(i, dir, float(t), tileSize, isVert, tx, ty, world.getMapId(ty, tx));
+        }
+    }
+
+
+    inline void RayCastable::setHit(size_t i, const Vector &dir, float t, float tileSize, bool isVert, int tx, int ty, int id)
+    {
+        const float len = t * tileSize;
+        const float hitX = pos.x + dir.x * len;
+        const float hitY = pos.y + dir.y * len;
+
+        // a ray that crossed a horizontal grid line runs along x on the wall face
+        const float along = (isVert ? hitX : hitY) / tileSize;
+
+        rayBuffer.dist[i] = offsetCos[i] * len;
+        rayBuffer.hitX[i] = hitX;
+        rayBuffer.hitY[i] = hitY;
+        rayBuffer.cellX[i] = tx;
+        rayBuffer.cellY[i] = ty;
+        rayBuffer.tileId[i] = id;
+        rayBuffer.wallX[i] = along - std::floor(along);
+        rayBuffer.isVert[i] = isVert;
+    }
+
+
+#if RCC_PACKET_WIDTH > 1
+    namespace packet
+    {
+    #if RCC_PACKET_WIDTH == 8
+        using floatv = __m256;
+        using intv = __m256i;
+        inline floatv load(const float* p) { return _mm256_load_ps(p); }
+        inline void store(float* p, floatv v) { _mm256_store_ps(p, v); }
+        inline void store(int* p, intv v) { _mm256_store_si256(reinterpret_cast<intv*>(p), v); }
+        inline floatv splat(float f) { return _mm256_set1_ps(f); }
+        inline intv splat(int i) { return _mm256_set1_epi32(i); }
+        inline floatv add(floatv a, floatv b) { return _mm256_add_ps(a, b); }
+        inline floatv mul(floatv a, floatv b) { return _mm256_mul_ps(a, b); }
+        inline floatv div(floatv a, floatv b) { return _mm256_div_ps(a, b); }
+        inline intv add(intv a, intv b) { return _mm256_add_epi32(a, b); }
+        inline floatv lessThan(floatv a, floatv b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        inline floatv equal(floatv a, floatv b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+        inline floatv bitAnd(floatv a, floatv b) { return _mm256_and_ps(a, b); }
+        inline floatv bitAndNot(floatv mask, floatv a) { return _mm256_andnot_ps(mask, a); }
+        inline intv bitAnd(floatv mask, intv a) { return _mm256_and_si256(_mm256_castps_si256(mask), a); }
+        inline intv bitAndNot(floatv mask, intv a) { return _mm256_andnot_si256(_mm256_castps_si256(mask), a); }
+        inline floatv select(floatv mask, floatv a, floatv b) { return _mm256_blendv_ps(b, a, mask); }
+        inline intv select(floatv mask, intv a, intv b) { return _mm256_blendv_epi8(b, a, _mm256_castps_si256(mask)); }
+        inline int laneMask(floatv mask) { return _mm256_movemask_ps(mask); }
+    #else
+        using floatv = __m128;
+        using intv = __m128i;
+        inline floatv load(const float* p) { return _mm_load_ps(p); }
+        inline void store(float* p, floatv v) { _mm_store_ps(p, v); }
+        inline void store(int* p, intv v) { _mm_store_si128(reinterpret_cast<intv*>(p), v); }
+        inline floatv splat(float f) { return _mm_set1_ps(f); }
+        inline intv splat(int i) { return _mm_set1_epi32(i); }
+        inline floatv add(floatv a, floatv b) { return _mm_add_ps(a, b); }
+        inline floatv mul(floatv a, floatv b) { return _mm_mul_ps(a, b); }
+        inline floatv div(floatv a, floatv b) { return _mm_div_ps(a, b); }
+        inline intv add(intv a, intv b) { return _mm_add_epi32(a, b); }
+        inline floatv lessThan(floatv a, floatv b) { return _mm_cmplt_ps(a, b); }
+        inline floatv equal(floatv a, floatv b) { return _mm_cmpeq_ps(a, b); }
+        inline floatv bitAnd(floatv a, floatv b) { return _mm_and_ps(a, b); }
+        inline floatv bitAndNot(floatv mask, floatv a) { return _mm_andnot_ps(mask, a); }
+        inline intv bitAnd(floatv mask, intv a) { return _mm_and_si128(_mm_castps_si128(mask), a); }
+        inline intv bitAndNot(floatv mask, intv a) { return _mm_andnot_si128(_mm_castps_si128(mask), a); }
+        inline floatv select(floatv mask, floatv a, floatv b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+        inline intv select(floatv mask, intv a, intv b) { return _mm_or_si128(bitAnd(mask, a), bitAndNot(mask, b)); }
+        inline int laneMask(floatv mask) { return _mm_movemask_ps(mask); }
+    #endif
+    }
+#endif
+
+
+    inline void RayCastable::castRayPackets(const World &world, size_t first, size_t last)
+    {
+        switch (world.getMapLayout())
+        {
+            case MapLayout::RowMajor: tracePackets<MapLayout::RowMajor>(world, first, last); break;
+            case MapLayout::Tiled: tracePackets<MapLayout::Tiled>(world, first, last); break;
+            case MapLayout::Morton: tracePackets<MapLayout::Morton>(world, first, last); break;
+            case MapLayout::Chunked: tracePackets<MapLayout::Chunked>(world, first, last); break;
+        }
+    }
+
+
+    template<MapLayout Layout>
+    inline void RayCastable::tracePackets(const World &world, size_t first, size_t last)
+    {
+        size_t i = first;
+    #if RCC_PACKET_WIDTH > 1
+        using namespace packet;
+        constexpr int W = RCC_PACKET_WIDTH;
+
+        const float tileSize = world.getTileSize();
+        const Vector origin = pos * (1.0f / tileSize);
+        const int originX = std::floor(origin.x);
+        const int originY = std::floor(origin.y);
+
+        // the scalar tMax setup split into per-castable terms, so every lane does
+        // the exact float operations castRay does and lands in the same cells
+        const floatv nearNegX = splat(origin.x - originX), nearPosX = splat(originX + 1 - origin.x);
+        const floatv nearNegY = splat(origin.y - originY), nearPosY = splat(originY + 1 - origin.y);
+        const floatv zero = splat(0.0f), one = splat(1.0f);
+        const floatv inf = splat(std::numeric_limits<float>::infinity());
+        const floatv absMask = splat(-0.0f);
+        const intv minusOne = splat(-1), plusOne = splat(1);
+        const Vector view = Vector::fromAngle(degToRad(rotation));
+
+        alignas(32) float dx[W], dy[W], t[W];
+        alignas(32) int tx[W], ty[W];
+
+        for(; i + W <= last; i += W)
+        {
+            for(int l = 0; l < W; l++) {
+                const Vector dir = getRayDir(i + l, view);
+                dx[l] = dir.x;
+                dy[l] = dir.y;
+            }
+
+            const floatv dirX = load(dx), dirY = load(dy);
+            const floatv negX = lessThan(dirX, zero), negY = lessThan(dirY, zero);
+            const floatv flatX = equal(dirX, zero), flatY = equal(dirY, zero);
+            const intv stepX = select(negX, minusOne, plusOne);
+            const intv stepY = select(negY, minusOne, plusOne);
+            const floatv tDeltaX = select(flatX, inf, bitAndNot(absMask, div(one, dirX)));
+            const floatv tDeltaY = select(flatY, inf, bitAndNot(absMask, div(one, dirY)));
+            floatv tMaxX = select(flatX, inf, mul(select(negX, nearNegX, nearPosX), tDeltaX));
+            floatv tMaxY = select(flatY, inf, mul(select(negY, nearNegY, nearPosY), tDeltaY));
+
+            intv cellX = splat(originX), cellY = splat(originY);
+            int active = (1 << W) - 1;
+            while (active)
+            {
+                // every lane steps, lanes that already hit just keep walking and
+                // are masked out of the lookups below
+                const floatv alongX = lessThan(tMaxX, tMaxY);
+                cellX = add(cellX, bitAnd(alongX, stepX));
+                cellY = add(cellY, bitAndNot(alongX, stepY));
+                store(t, select(alongX, tMaxX, tMaxY));
+                tMaxX = add(tMaxX, bitAnd(alongX, tDeltaX));
+                tMaxY = add(tMaxY, bitAndNot(alongX, tDeltaY));
+
+                const int xLanes = laneMask(alongX);
+                store(tx, cellX);
+                store(ty, cellY);
+                int solid = 0;
+                for(int l = 0; l < W; l++)
+                    solid |= world.isSolidIn<Layout>(ty[l], tx[l]) << l;
+
+                for(int lanes = solid & active; lanes; lanes &= lanes - 1)
+                {
+                    const int l = std::countr_zero(static_cast<unsigned>(lanes));
+                    setHit(i + l, Vector{ dx[l], dy[l] }, t[l], tileSize, !(xLanes >> l & 1), tx[l], ty[l], world.getMapId(ty[l], tx[l]));
+                }
+                active &= ~solid;
+            }
+        }
+    #endif
+        traceRays<float, Layout>(world, i, last);
+    }
+
+    inline WorkerPool::WorkerPool(unsigned workerCount)
+    {
+    #if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+        workerCount = 0;    // std::thread is unavailable without -pthread
+    #endif
+        for(unsigned i = 0; i < workerCount; i++)
+            workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+
+    inline WorkerPool::~WorkerPool()
+    {
         {
-            float angle = degToRad(it->angle + rotation);
-            it->dir = Vector::fromAngle(angle);
-            it->start = pos;
-            it->xIntercept = getRayHorizontalIntercept(angle, world);
-            it->yIntercept = getRayVerticalIntercept(angle, world);
-            auto& minIntercept = it->xIntercept.getLength() < it->yIntercept.getLength() ? it->xIntercept : it->yIntercept;
-            it->isVert = !(&minIntercept == &it->xIntercept);
-            it->dist = std::cos(angle) * minIntercept.getLength();
-            it->end = pos + it->dir * minIntercept.getLength();
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
         }
+        wake.notify_all();
+        for(auto& worker: workers)
+            worker.join();
     }
 
+    inline void WorkerPool::run(size_t count, const std::function<void(size_t)> &task)
+    {
+        if(workers.empty() || count < 2) {
+            for(size_t i = 0; i < count; i++)
+                task(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->task = &task;
+            taskCount = count;
+            nextTask = 0;
+            activeWorkers = workers.size();
+            generation++;
+        }
+        wake.notify_all();
+
+        drain();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return activeWorkers == 0; });
+        this->task = nullptr;
+    }
+
+    inline unsigned WorkerPool::getWorkerCount() const
+    {
+        return workers.size();
+    }
+
+    inline void WorkerPool::workerLoop()
+    {
+        RCC_THREAD_NAME("rcc worker");
+        unsigned seen = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if(stopping) return;
+                seen = generation;
+            }
+
+            drain();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if(--activeWorkers == 0)
+                done.notify_one();
+        }
+    }
+
+    inline void WorkerPool::drain()
+    {
+        for(size_t i = nextTask++; i < taskCount; i = nextTask++)
+            (*task)(i);
+    }
+
+
     float degToRad(const float& f)
     {
         return f * PI / 180;
@@ -402,14 +1325,150 @@ namespace rcc
 
     inline int World::getMapId(const int &y, const int &x) const
     {
-        int res;
-        try {
-            res = currMap->at(y * colSize + x);
-        } catch(...) {
-            res = -1;
+        // negative indices wrap to huge unsigned values, so one compare per axis
+        // rejects both sides of the map without throwing
+        if(static_cast<unsigned>(x) >= static_cast<unsigned>(colSize) ||
+           static_cast<unsigned>(y) >= static_cast<unsigned>(rowSize))
+            return -1;
+        if(chunks) {
+            const MapChunk* chunk = chunks[(y >> MapChunk::shift) * chunksX + (x >> MapChunk::shift)];
+            return chunk ? chunk->ids[(y & (MapChunk::size - 1)) * MapChunk::size + (x & (MapChunk::size - 1))] : unloadedTile;
         }
+        return currMap[y * colSize + x];
+    }
 
-        return res;
+    inline bool World::isSolid(const int &y, const int &x) const
+    {
+        switch (getMapLayout())
+        {
+            case MapLayout::Tiled: return isSolidIn<MapLayout::Tiled>(y, x);
+            case MapLayout::Morton: return isSolidIn<MapLayout::Morton>(y, x);
+            case MapLayout::Chunked: return isSolidIn<MapLayout::Chunked>(y, x);
+            default: return isSolidIn<MapLayout::RowMajor>(y, x);
+        }
+    }
+
+    template<MapLayout Layout>
+    inline bool World::isSolidIn(const int &y, const int &x) const
+    {
+        if(static_cast<unsigned>(x) >= static_cast<unsigned>(colSize) ||
+           static_cast<unsigned>(y) >= static_cast<unsigned>(rowSize))
+            return true;
+
+        if constexpr (Layout == MapLayout::Chunked) {
+            // a chunk that is not resident stops the ray like a wall would
+            const MapChunk* chunk = chunks[(y >> MapChunk::shift) * chunksX + (x >> MapChunk::shift)];
+            if(!chunk) return true;
+            const int cy = y & (MapChunk::size - 1), cx = x & (MapChunk::size - 1);
+            return chunk->occupancy[cy * (MapChunk::size / 64) + (cx >> 6)] >> (cx & 63) & 1;
+        } else {
+            const auto [word, bit] = locateTile<Layout>(y, x);
+            return occupancyBits[word] >> bit & 1;
+        }
+    }
+
+    inline void MapChunk::buildOccupancy()
+    {
+        std::fill(std::begin(occupancy), std::end(occupancy), 0);
+        for(int i = 0; i < size * size; i++)
+            occupancy[i >> 6] |= std::uint64_t(ids[i] != 0) << (i & 63);
+    }
+
+    /// @brief Spread the low 16 bits of v to the even bits of the result, a
+    /// byte at a time through a table
+    inline std::uint32_t spreadBits(std::uint32_t v)
+    {
+        static constexpr auto table = [] {
+            std::array<std::uint16_t, 256> t{};
+            for(unsigned i = 0; i < 256; i++)
+                for(int b = 0; b < 8; b++)
+                    t[i] |= (i >> b & 1) << (2 * b);
+            return t;
+        }();
+        return table[v & 0xff] | std::uint32_t(table[v >> 8 & 0xff]) << 16;
+    }
+
+    template<MapLayout Layout>
+    inline std::pair<size_t, int> World::locateTile(int y, int x) const
+    {
+        if constexpr (Layout == MapLayout::RowMajor)
+            return { (size_t(y) << occupancyShift) + (x >> 6), x & 63 };
+
+        // a block is one word, its 8 rows of 8 bits stacked
+        const int bit = (y & 7) << 3 | (x & 7);
+        if constexpr (Layout == MapLayout::Tiled)
+            return { (size_t(y >> 3) << occupancyShift) + (x >> 3), bit };
+        else
+            return { spreadBits(x >> 3) | spreadBits(y >> 3) << 1, bit };
+    }
+
+    inline void World::setMapLayout(MapLayout layout)
+    {
+        if(layout == MapLayout::Chunked) return;
+        this->layout = layout;
+        if(currMap) buildOccupancy();
+    }
+
+    inline MapLayout World::getMapLayout() const
+    {
+        return chunks ? MapLayout::Chunked : layout;
+    }
+
+    inline const std::uint64_t *World::getOccupancy() const
+    {
+        return occupancyBits;
+    }
+
+    inline size_t World::getOccupancyWords(MapLayout layout, int col, int row)
+    {
+        // rows or rows of blocks padded to a power of two words, Morton pads the
+        // blocks to a square a power of two a side
+        const unsigned blocksX = (col + 7) / 8, blocksY = (row + 7) / 8;
+        const size_t side = std::bit_ceil(std::max(blocksX, blocksY));
+        switch (layout)
+        {
+            case MapLayout::Tiled: return size_t(blocksY) * std::bit_ceil(blocksX);
+            case MapLayout::Morton: return side * side;
+            case MapLayout::Chunked: return 0;
+            default: return size_t(row) * std::bit_ceil(unsigned(col + 63) / 64);
+        }
+    }
+
+    inline void World::buildOccupancy()
+    {
+        switch (layout)
+        {
+            case MapLayout::RowMajor: occupancyShift = std::countr_zero(std::bit_ceil(unsigned(colSize + 63) / 64)); break;
+            case MapLayout::Tiled: occupancyShift = std::countr_zero(std::bit_ceil(unsigned(colSize + 7) / 8)); break;
+            case MapLayout::Morton: occupancyShift = 0; break;
+            case MapLayout::Chunked: break;
+        }
+
+        if(givenOccupancy && layout == MapLayout::RowMajor) {
+            occupancy.clear();
+            occupancyBits = givenOccupancy;
+            return;
+        }
+
+        occupancy.assign(getOccupancyWords(layout, colSize, rowSize), 0);
+        occupancyBits = occupancy.data();
+        for(int y = 0; y < rowSize; y++)
+            for(int x = 0; x < colSize; x++)
+                if(currMap[y * colSize + x] != 0) setOccupied(y, x, true);
+    }
+
+    inline void World::setOccupied(int y, int x, bool solid)
+    {
+        std::pair<size_t, int> at;
+        switch (layout)
+        {
+            case MapLayout::Tiled: at = locateTile<MapLayout::Tiled>(y, x); break;
+            case MapLayout::Morton: at = locateTile<MapLayout::Morton>(y, x); break;
+            default: at = locateTile<MapLayout::RowMajor>(y, x); break;
+        }
+        std::uint64_t& word = occupancy[at.first];
+        const std::uint64_t bit = std::uint64_t(1) << at.second;
+        word = solid ? word | bit : word & ~bit;
     }
 
     inline const int &World::getRowSize() const
@@ -427,11 +1486,255 @@ namespace rcc
         return tileSize;
     }
 
-    inline void World::update(float dt)
+    inline void World::setWorkerCount(unsigned count)
+    {
+        pool = count ? std::make_unique<WorkerPool>(count) : nullptr;
+    }
+
+    inline void World::setPacketCasting(bool enabled)
+    {
+        packetCasting = enabled;
+    }
+
+    inline void World::markMapChanged()
+    {
+        mapGeneration++;
+        if(chunks) return;
+        givenOccupancy = nullptr;
+        buildOccupancy();
+        buildAcceleration();
+    }
+
+    inline void World::setAcceleration(Acceleration mode)
+    {
+        acceleration = mode;
+        buildAcceleration();
+    }
+
+    inline Acceleration World::getAcceleration() const
+    {
+        return acceleration;
+    }
+
+    inline void World::markTileChanged(const int &y, const int &x)
+    {
+        mapGeneration++;
+        if(chunks || static_cast<unsigned>(x) >= static_cast<unsigned>(colSize) ||
+           static_cast<unsigned>(y) >= static_cast<unsigned>(rowSize))
+            return;
+        if(givenOccupancy) {
+            // the given bitmap is never written to, patch a copy from now on
+            givenOccupancy = nullptr;
+            buildOccupancy();
+        }
+        setOccupied(y, x, currMap[y * colSize + x] != 0);
+
+        if(acceleration == Acceleration::DistanceField) {
+            buildDistanceField();
+            return;
+        }
+        if(pyramid.empty()) return;
+
+        // only the one cell per level above the tile can change
+        pyramid[0].cells[y * colSize + x] = isSolid(y, x);
+        for(size_t level = 1; level < pyramid.size(); level++)
+            updatePyramidCell(level, y >> level, x >> level);
+    }
+
+    inline int World::getEmptyLevel(const int &y, const int &x, int guess) const
+    {
+        // a block is empty only if every block under it is, so walk up from
+        // the guess while blocks are empty and down while they are not
+        auto isEmpty = [&](int level) {
+            const OccupancyLevel& l = pyramid[level];
+            const int bx = x >> level, by = y >> level;
+            return static_cast<unsigned>(bx) < static_cast<unsigned>(l.width) &&
+                   static_cast<unsigned>(by) < static_cast<unsigned>(l.height) &&
+                   !l.cells[by * l.width + bx];
+        };
+
+        const int top = int(pyramid.size()) - 1;
+        int level = std::clamp(guess, 0, std::max(top, 0));
+        if(level > 0 && !isEmpty(level)) {
+            while (--level > 0 && !isEmpty(level));
+            return level;
+        }
+        while (level < top && isEmpty(level + 1))
+            level++;
+        return level;
+    }
+
+    inline int World::getClearance(const int &y, const int &x) const
+    {
+        if(clearance.empty() || static_cast<unsigned>(x) >= static_cast<unsigned>(colSize) ||
+           static_cast<unsigned>(y) >= static_cast<unsigned>(rowSize))
+            return 0;
+        return clearance[y * colSize + x];
+    }
+
+    inline void World::buildAcceleration()
+    {
+        buildPyramid();
+        buildDistanceField();
+    }
+
+    inline void World::buildDistanceField()
     {
-        player->castRay(*this);
+        clearance.clear();
+        if(acceleration != Acceleration::DistanceField || !currMap) return;
+
+        // two pass chamfer over the 8 neighbours with unit weights is exact for
+        // the Chebyshev metric. Outside the map counts as solid, so the square
+        // a cell vouches for never reaches past the edge
+        clearance.resize(size_t(colSize) * rowSize);
+        auto at = [&](int y, int x) -> int {
+            if(static_cast<unsigned>(x) >= static_cast<unsigned>(colSize) ||
+               static_cast<unsigned>(y) >= static_cast<unsigned>(rowSize))
+                return 0;
+            return clearance[y * colSize + x];
+        };
+
+        for(int y = 0; y < rowSize; y++)
+            for(int x = 0; x < colSize; x++)
+            {
+                unsigned char& d = clearance[y * colSize + x];
+                if(isSolid(y, x)) {
+                    d = 0;
+                    continue;
+                }
+                const int nearest = std::min({ at(y, x - 1), at(y - 1, x - 1), at(y - 1, x), at(y - 1, x + 1) });
+                d = std::min(nearest + 1, 255);
+            }
+
+        for(int y = rowSize - 1; y >= 0; y--)
+            for(int x = colSize - 1; x >= 0; x--)
+            {
+                unsigned char& d = clearance[y * colSize + x];
+                const int nearest = std::min({ at(y, x + 1), at(y + 1, x + 1), at(y + 1, x), at(y + 1, x - 1) });
+                d = std::min<int>(d, nearest + 1);
+            }
+    }
+
+    inline void World::buildPyramid()
+    {
+        pyramid.clear();
+        if(acceleration != Acceleration::Pyramid || !currMap) return;
+
+        OccupancyLevel& base = pyramid.emplace_back();
+        base.width = colSize;
+        base.height = rowSize;
+        base.cells.resize(size_t(colSize) * rowSize);
+        for(int y = 0; y < rowSize; y++)
+            for(int x = 0; x < colSize; x++)
+                base.cells[y * colSize + x] = isSolid(y, x);
+
+        // halve until a single block covers the map
+        while (pyramid.back().width > 1 || pyramid.back().height > 1)
+        {
+            const OccupancyLevel& below = pyramid.back();
+            OccupancyLevel level;
+            level.width = (below.width + 1) / 2;
+            level.height = (below.height + 1) / 2;
+            level.cells.resize(size_t(level.width) * level.height);
+            pyramid.push_back(std::move(level));
+
+            for(int y = 0; y < pyramid.back().height; y++)
+                for(int x = 0; x < pyramid.back().width; x++)
+                    updatePyramidCell(pyramid.size() - 1, y, x);
+        }
+    }
+
+    inline void World::updatePyramidCell(size_t level, int y, int x)
+    {
+        const OccupancyLevel& below = pyramid[level - 1];
+        unsigned char occupied = 0;
+        for(int cy = 2 * y; cy < 2 * y + 2; cy++)
+            for(int cx = 2 * x; cx < 2 * x + 2; cx++)
+                occupied |= cx >= below.width || cy >= below.height || below.cells[cy * below.width + cx];
+
+        OccupancyLevel& l = pyramid[level];
+        l.cells[y * l.width + x] = occupied;
+    }
+
+    inline unsigned World::getMapGeneration() const
+    {
+        return mapGeneration;
+    }
+
+    inline size_t World::getSkippedCasts() const
+    {
+        return skippedCasts;
+    }
+
+    inline size_t World::getShiftedCasts() const
+    {
+        return shiftedCasts;
+    }
+
+    inline void World::update([[maybe_unused]] float dt)
+    {
+        auto cast = [this](RayCastable& castable, size_t first, size_t last) {
+            RCC_PROFILE_SCOPE("castRay");
+            if(packetCasting) castable.castRayPackets(*this, first, last);
+            else castable.castRay(*this, first, last);
+        };
+
+        // a castable whose pose and map are what they were at its last cast
+        // would get the same rays again, one that only turned keeps the columns
+        // still in view
+        skippedCasts = 0;
+        castRanges.clear();
+        auto collect = [&](RayCastable& castable) {
+            if(!castable.isDirty(*this)) {
+                skippedCasts++;
+                return;
+            }
+
+            // a shift is remembered at the rotation it lined up with, so what is
+            // left of the turn is not lost, and the new columns are cast at that
+            // rotation too. Turns of less than a column are cast in full
+            size_t first = 0, last = castable.getRayBuffer().size();
+            float castRotation = castable.rotation;
+            const bool turnedOnly = castable.hasCast && castable.castGeneration == mapGeneration &&
+                                    castable.pos.x == castable.castPos.x && castable.pos.y == castable.castPos.y;
+            if(turnedOnly && castable.shiftRays(castable.castRotation, first, last, castRotation)) {
+                shiftedCasts++;
+                shiftedRotations.push_back({ &castable, castable.rotation });
+                castable.rotation = castRotation;
+            }
+
+            castable.castPos = castable.pos;
+            castable.castRotation = castRotation;
+            castable.castGeneration = mapGeneration;
+            castable.hasCast = true;
+            if(first < last) castRanges.push_back({ &castable, first, last });
+        };
+
+        shiftedCasts = 0;
+        shiftedRotations.clear();
+        collect(*player);
         for(auto it = rayCastables.begin(); it != rayCastables.end(); it++)
-            it->castRay(*this);
+            collect(*it);
+
+        if(!pool || pool->getWorkerCount() == 0) {
+            for(const CastJob& range: castRanges)
+                cast(*range.castable, range.first, range.last);
+        } else {
+            // split every view into fixed slices of columns; each job owns disjoint
+            // ray slots, so the output is the same whatever order the jobs run in
+            castJobs.clear();
+            for(const CastJob& range: castRanges)
+                for(size_t first = range.first; first < range.last; first += raysPerJob)
+                    castJobs.push_back({ range.castable, first, std::min(range.last, first + raysPerJob) });
+
+            pool->run(castJobs.size(), [&](size_t i) {
+                const CastJob& job = castJobs[i];
+                cast(*job.castable, job.first, job.last);
+            });
+        }
+
+        for(const auto& [castable, rotation]: shiftedRotations)
+            castable->rotation = rotation;
     }
 
     inline World::World(const int &tileSize, const Vector &_size)
@@ -457,9 +1760,34 @@ namespace rcc
 
     inline void World::setWorldInfo(const std::vector<int> &map, const unsigned &col, const unsigned &row)
     {
-        currMap = &map;
+        setWorldInfo(map.data(), col, row);
+    }
+
+    inline void World::setWorldInfo(const int *map, const unsigned &col, const unsigned &row, const std::uint64_t *occupancy)
+    {
+        chunks = nullptr;
+        currMap = map;
+        givenOccupancy = occupancy;
         colSize = col;
         rowSize = row;
+        mapGeneration++;
+        buildOccupancy();
+        buildAcceleration();
+    }
+
+
+    inline void World::setStreamedMap(const MapChunk *const *chunks, const unsigned &col, const unsigned &row)
+    {
+        this->chunks = chunks;
+        chunksX = (col + MapChunk::size - 1) >> MapChunk::shift;
+        currMap = nullptr;
+        givenOccupancy = nullptr;
+        occupancy.clear();
+        occupancyBits = nullptr;
+        colSize = col;
+        rowSize = row;
+        mapGeneration++;
+        buildAcceleration();
     }
 
 
@@ -469,6 +1797,12 @@ namespace rcc
     }
 
 
+    inline RayCastable *World::getPlayer() const
+    {
+        return player;
+    }
+
+
     inline const Vector &World::getSize() const
     {
         return size;
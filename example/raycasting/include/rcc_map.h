@@ -0,0 +1,371 @@
+/**
+ * @file rcc_map.h
+ * @date 16-oct-2026
+ * Binary map files for rcc. A file is mapped into memory and World reads
+ * the tiles straight from the mapping, so opening a level costs a few page
+ * table entries instead of parsing and copying every tile.
+ *
+ * Layout, all little endian:
+ *   MapFileHeader                  magic "RCCM", version, size, layer count
+ *   MapLayerEntry[layerCount]      kind, offset and size of every layer
+ *   layers                         each at a multiple of mapFileAlignment,
+ *                                  zero padding in between
+ *
+ * Version 1 has two layers. Ids is required, Occupancy lets World skip
+ * building its bitmap. Readers skip layer kinds they do not know
+ */
+#ifndef __BYTENOL_RCC_MAP_H__
+#define __BYTENOL_RCC_MAP_H__
+
+#include <bit>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "rcc.h"
+
+#if __has_include(<sys/mman.h>) && !defined(__EMSCRIPTEN__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define RCC_HAS_MMAP 1
+#else
+    #define RCC_HAS_MMAP 0
+#endif
+
+
+namespace rcc
+{
+
+    /// The kinds of layer a map file can hold
+    enum class MapLayer : std::uint32_t
+    {
+        Ids = 1,        // one int32 tile id per tile, row by row
+        Occupancy = 2,  // the MapLayout::RowMajor bitmap World::getOccupancy() gives
+    };
+
+    constexpr char mapFileMagic[4] = { 'R', 'C', 'C', 'M' };
+    constexpr std::uint32_t mapFileVersion = 1;
+    constexpr std::uint64_t mapFileAlignment = 64;    // a cache line, and enough for any layer type
+
+    // layers are used in place, so the host has to share the file's byte order
+    static_assert(std::endian::native == std::endian::little, "map files are little endian");
+
+    struct MapFileHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t cols;
+        std::uint32_t rows;
+        std::uint32_t layerCount;
+        std::uint32_t reserved;     // zero
+    };
+
+    struct MapLayerEntry
+    {
+        std::uint32_t kind;         // a MapLayer
+        std::uint32_t reserved;     // zero
+        std::uint64_t offset;       // from the start of the file
+        std::uint64_t size;         // in bytes, without padding
+    };
+
+
+    /// @brief Write a map file with both layers
+    /// @param path is where to write the file
+    /// @param ids is cols * rows tile ids, row by row
+    /// @param cols is the size of the column in the map
+    /// @param rows is the size of the row in the map
+    /// @return false if ids does not match the size or the file could not be written
+    bool writeMapFile(const char* path, const std::vector<int>& ids, unsigned cols, unsigned rows);
+
+    /// @brief Read a map written as text, either CSV with one row per line or a
+    /// C++ initializer list such as the levelMap literals of the examples, with
+    /// one row per line between the first { and the next }. // comments are skipped
+    /// @param text is the whole text
+    /// @param ids receives the tile ids, row by row
+    /// @param cols is the size of the column in the map, or 0 to take it from the
+    /// first row. Set to the size read. A map on a single line is cut into rows
+    /// of cols tiles
+    /// @param rows receives the size of the row in the map
+    /// @return false if there are no tiles or the rows are not all cols long
+    bool readMapText(const std::string& text, std::vector<int>& ids, unsigned& cols, unsigned& rows);
+
+    /// @brief Check the header of a map file and that its layer table fits in the file
+    /// @param header is the header read from the start of the file
+    /// @param fileSize is the size of the whole file in bytes
+    /// @param error receives why the file is rejected
+    /// @return false if the file is not a map file this version can read
+    bool checkMapFileHeader(const MapFileHeader& header, std::uint64_t fileSize, std::string& error);
+
+    /// @brief Check an entry of the layer table. Every layer has to be aligned and
+    /// inside the file, the layers this version knows also have to fit the map
+    /// @param header is the checked header of the file
+    /// @param layer is the entry
+    /// @param index is the position of the entry in the table, for the error
+    /// @param fileSize is the size of the whole file in bytes
+    /// @param error receives why the layer is rejected
+    /// @return false if the layer cannot be read
+    bool checkMapLayer(const MapFileHeader& header, const MapLayerEntry& layer, std::uint32_t index, std::uint64_t fileSize, std::string& error);
+
+
+    /// A map file opened for reading. The tiles stay mapped, and valid for any
+    /// World given them, until the file is closed or destroyed
+    class MapFile
+    {
+        public:
+            MapFile() = default;
+            ~MapFile();
+
+            MapFile(const MapFile&) = delete;
+            MapFile& operator=(const MapFile&) = delete;
+
+            /// @brief Map a map file, closing any file opened before
+            /// @param path is the path to the file
+            /// @return false if the file could not be read or is not a valid map
+            /// file, see getError()
+            bool open(const char* path);
+
+            void close();
+
+            /// @brief Give the mapped tiles to a world, nothing is copied
+            void applyTo(World& world) const;
+
+            const int* getIds() const;
+
+            /// @brief Get the stored occupancy bitmap
+            /// @return nullptr if the file has no Occupancy layer
+            const std::uint64_t* getOccupancy() const;
+
+            unsigned getCols() const;
+
+            unsigned getRows() const;
+
+            /// @brief Get why the last open() failed
+            const std::string& getError() const;
+
+        private:
+            bool fail(const std::string& why);
+
+            const unsigned char* data = nullptr;
+            size_t size = 0;
+            bool mapped = false;
+            std::vector<std::uint64_t> buffer;  // the file contents where mmap is unavailable
+
+            const int* ids = nullptr;
+            const std::uint64_t* occupancy = nullptr;
+            unsigned cols = 0;
+            unsigned rows = 0;
+            std::string error;
+    };
+
+
+    inline bool writeMapFile(const char *path, const std::vector<int> &ids, unsigned cols, unsigned rows)
+    {
+        if(ids.size() != size_t(cols) * rows) return false;
+
+        // the bitmap exactly as World builds it, so loading can use it in place
+        auto world = createWorld(1, Vector{});
+        world->setWorldInfo(ids, cols, rows);
+        const size_t words = World::getOccupancyWords(MapLayout::RowMajor, cols, rows);
+
+        auto alignUp = [](std::uint64_t n) { return (n + mapFileAlignment - 1) / mapFileAlignment * mapFileAlignment; };
+        MapFileHeader header{ { mapFileMagic[0], mapFileMagic[1], mapFileMagic[2], mapFileMagic[3] }, mapFileVersion, cols, rows, 2, 0 };
+        MapLayerEntry layers[2];
+        layers[0] = { std::uint32_t(MapLayer::Ids), 0, alignUp(sizeof(header) + sizeof(layers)), ids.size() * sizeof(std::int32_t) };
+        layers[1] = { std::uint32_t(MapLayer::Occupancy), 0, alignUp(layers[0].offset + layers[0].size), words * sizeof(std::uint64_t) };
+
+        std::ofstream file(path, std::ios::binary);
+        if(!file) return false;
+        auto padTo = [&](std::uint64_t offset) {
+            static const char zeros[mapFileAlignment] = {};
+            file.write(zeros, offset - std::uint64_t(file.tellp()));
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(layers), sizeof(layers));
+        padTo(layers[0].offset);
+        file.write(reinterpret_cast<const char*>(ids.data()), layers[0].size);
+        padTo(layers[1].offset);
+        file.write(reinterpret_cast<const char*>(world->getOccupancy()), layers[1].size);
+        return bool(file);
+    }
+
+    inline bool readMapText(const std::string &text, std::vector<int> &ids, unsigned &cols, unsigned &rows)
+    {
+        size_t begin = 0, end = text.size();
+        const size_t brace = text.find('{');
+        if(brace != std::string::npos) {
+            begin = brace + 1;
+            end = std::min(text.find('}', begin), text.size());
+        }
+
+        ids.clear();
+        std::vector<size_t> rowLengths;
+        size_t rowStart = 0;
+        for(size_t i = begin; i < end; i++)
+        {
+            const char c = text[i];
+            if(c == '/' && i + 1 < end && text[i + 1] == '/') {
+                i = std::min(text.find('\n', i), end) - 1;
+            } else if(c == '\n') {
+                if(ids.size() > rowStart) rowLengths.push_back(ids.size() - rowStart);
+                rowStart = ids.size();
+            } else if(std::isdigit(static_cast<unsigned char>(c)) ||
+                      (c == '-' && i + 1 < end && std::isdigit(static_cast<unsigned char>(text[i + 1])))) {
+                char* stop = nullptr;
+                ids.push_back(int(std::strtol(text.c_str() + i, &stop, 10)));
+                i = stop - text.c_str() - 1;
+            }
+        }
+        if(ids.size() > rowStart) rowLengths.push_back(ids.size() - rowStart);
+        if(ids.empty()) return false;
+
+        // every line is a row, only a map on a single line is cut every cols
+        if(cols == 0) cols = rowLengths.front();
+        if(rowLengths.size() > 1)
+            for(size_t length: rowLengths)
+                if(length != cols) return false;
+        rows = ids.size() / cols;
+        return ids.size() == size_t(cols) * rows;
+    }
+
+    inline bool checkMapFileHeader(const MapFileHeader &header, std::uint64_t fileSize, std::string &error)
+    {
+        if(fileSize < sizeof(header)) error = "file too small for a header";
+        else if(std::memcmp(header.magic, mapFileMagic, sizeof(mapFileMagic)) != 0) error = "not a map file";
+        else if(header.version != mapFileVersion) error = "unsupported map file version " + std::to_string(header.version);
+        else if(header.layerCount > (fileSize - sizeof(header)) / sizeof(MapLayerEntry)) error = "layer table past the end of the file";
+        else return true;
+        return false;
+    }
+
+    inline bool checkMapLayer(const MapFileHeader &header, const MapLayerEntry &layer, std::uint32_t index, std::uint64_t fileSize, std::string &error)
+    {
+        if(layer.offset % mapFileAlignment != 0) error = "misaligned layer " + std::to_string(index);
+        else if(layer.offset > fileSize || layer.size > fileSize - layer.offset) error = "layer " + std::to_string(index) + " past the end of the file";
+        else if(layer.kind == std::uint32_t(MapLayer::Ids) && layer.size != std::uint64_t(header.cols) * header.rows * sizeof(std::int32_t))
+            error = "ids layer does not match the map size";
+        else if(layer.kind == std::uint32_t(MapLayer::Occupancy) &&
+                layer.size != World::getOccupancyWords(MapLayout::RowMajor, header.cols, header.rows) * sizeof(std::uint64_t))
+            error = "occupancy layer does not match the map size";
+        else return true;
+        return false;
+    }
+
+
+    inline MapFile::~MapFile()
+    {
+        close();
+    }
+
+    inline bool MapFile::open(const char *path)
+    {
+        close();
+
+    #if RCC_HAS_MMAP
+        const int fd = ::open(path, O_RDONLY);
+        if(fd < 0) return fail(std::string("unable to open ") + path);
+        struct stat info;
+        if(fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return fail(std::string("unable to read ") + path);
+        }
+        size = size_t(info.st_size);
+        void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);   // the mapping keeps the file alive
+        if(view == MAP_FAILED) return fail(std::string("unable to map ") + path);
+        data = static_cast<const unsigned char*>(view);
+        mapped = true;
+    #else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if(!file) return fail(std::string("unable to open ") + path);
+        size = size_t(file.tellg());
+        buffer.resize((size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+        file.seekg(0);
+        if(!file.read(reinterpret_cast<char*>(buffer.data()), size)) return fail(std::string("unable to read ") + path);
+        data = reinterpret_cast<const unsigned char*>(buffer.data());
+    #endif
+
+        MapFileHeader header{};
+        std::string why;
+        if(size >= sizeof(header)) std::memcpy(&header, data, sizeof(header));
+        if(!checkMapFileHeader(header, size, why)) return fail(why);
+
+        for(std::uint32_t i = 0; i < header.layerCount; i++)
+        {
+            MapLayerEntry layer;
+            std::memcpy(&layer, data + sizeof(header) + i * sizeof(layer), sizeof(layer));
+            if(!checkMapLayer(header, layer, i, size, why)) return fail(why);
+
+            if(layer.kind == std::uint32_t(MapLayer::Ids))
+                ids = reinterpret_cast<const int*>(data + layer.offset);
+            else if(layer.kind == std::uint32_t(MapLayer::Occupancy))
+                occupancy = reinterpret_cast<const std::uint64_t*>(data + layer.offset);
+        }
+        if(!ids) return fail("no ids layer");
+
+        cols = header.cols;
+        rows = header.rows;
+        return true;
+    }
+
+    inline void MapFile::close()
+    {
+    #if RCC_HAS_MMAP
+        if(mapped) munmap(const_cast<unsigned char*>(data), size);
+    #endif
+        buffer.clear();
+        data = nullptr;
+        size = 0;
+        mapped = false;
+        ids = nullptr;
+        occupancy = nullptr;
+        cols = rows = 0;
+    }
+
+    inline void MapFile::applyTo(World &world) const
+    {
+        world.setWorldInfo(ids, cols, rows, occupancy);
+    }
+
+    inline const int *MapFile::getIds() const
+    {
+        return ids;
+    }
+
+    inline const std::uint64_t *MapFile::getOccupancy() const
+    {
+        return occupancy;
+    }
+
+    inline unsigned MapFile::getCols() const
+    {
+        return cols;
+    }
+
+    inline unsigned MapFile::getRows() const
+    {
+        return rows;
+    }
+
+    inline const std::string &MapFile::getError() const
+    {
+        return error;
+    }
+
+    inline bool MapFile::fail(const std::string &why)
+    {
+        close();
+        error = why;
+        return false;
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,194 @@
+/**
+ * @file rcc_sprite.h
+ * @date 16-oct-2026
+ * Billboard sprites for rcc views. The walls a castable hit give a depth per
+ * column; every sprite is projected into the view, dropped if walls hide all
+ * of it, trimmed to the columns where it can show, and the survivors are
+ * radix sorted far to near so drawing them in order needs no depth tests
+ * between sprites
+ */
+#ifndef __BYTENOL_RCC_SPRITE_H__
+#define __BYTENOL_RCC_SPRITE_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "rcc.h"
+
+
+namespace rcc
+{
+
+    /// Depth of the walls in every column of a view, with a max pyramid above
+    /// it: every level halves the columns and keeps the farther depth of each
+    /// pair, so a span of any width is tested against the walls in a couple
+    /// of lookups per level
+    class DepthBuffer
+    {
+        public:
+            /// @brief Take the depths of a cast
+            /// @param rays is the ray buffer of the castable, one column per ray
+            void build(const RayBuffer& rays);
+
+            /// @brief Get the depth of the wall in a column
+            float at(int column) const;
+
+            /// @brief Get the farthest wall depth over the columns [first, last)
+            float farthest(int first, int last) const;
+
+            int size() const;
+
+        private:
+            // levels[k][i] is the farthest depth of columns [i * 2^k, (i + 1) * 2^k)
+            std::vector<std::vector<float>> levels;
+    };
+
+
+    struct Sprite
+    {
+        Vector pos;             // centre, in world space
+        float size = 64.0f;     // width in world units
+    };
+
+
+    /// A sprite that can show in a view
+    struct SpriteSpan
+    {
+        size_t sprite = 0;      // index into the sprite list
+        float depth = 0.0f;     // along the view direction, like RayBuffer::dist
+        float left = 0.0f;      // column of the left edge, may be off screen
+        float width = 0.0f;     // in columns
+        int first = 0;          // columns that are not behind a wall at both
+        int last = 0;           // ends, [first, last)
+    };
+
+
+    /// @brief Project sprites into a view and keep the ones walls do not hide
+    /// completely, far to near
+    /// @param viewer is the castable the view belongs to, cast already
+    /// @param depth is the depth buffer built from the viewer's rays
+    /// @param sprites are the sprites to show
+    /// @param visible receives the sprites that can show, sorted by decreasing depth.
+    /// Columns inside [first, last) can still be hidden, test them with at()
+    /// @param nearest is the closest depth drawn, sprites closer are dropped
+    void cullSprites(const RayCastable& viewer, const DepthBuffer& depth, const std::vector<Sprite>& sprites,
+                     std::vector<SpriteSpan>& visible, float nearest = 1.0f);
+
+    /// @brief Sort spans by decreasing depth, a least significant digit radix
+    /// sort over the bits of the depth
+    /// @param spans are the spans to sort
+    /// @param scratch is reused between calls to avoid allocating
+    void sortFarToNear(std::vector<SpriteSpan>& spans, std::vector<SpriteSpan>& scratch);
+
+
+    inline void DepthBuffer::build(const RayBuffer &rays)
+    {
+        // the levels keep their storage from frame to frame
+        size_t levelCount = 1;
+        for(size_t n = rays.size(); n > 1; n = (n + 1) / 2)
+            levelCount++;
+        levels.resize(levelCount);
+        levels[0].assign(rays.dist.begin(), rays.dist.end());
+
+        // an odd column out at the end of a level moves up on its own
+        for(size_t k = 1; k < levelCount; k++)
+        {
+            const std::vector<float>& below = levels[k - 1];
+            levels[k].resize((below.size() + 1) / 2);
+            for(size_t i = 0; i < levels[k].size(); i++)
+                levels[k][i] = 2 * i + 1 < below.size() ? std::max(below[2 * i], below[2 * i + 1]) : below[2 * i];
+        }
+    }
+
+    inline float DepthBuffer::at(int column) const
+    {
+        return levels[0][column];
+    }
+
+    inline float DepthBuffer::farthest(int first, int last) const
+    {
+        // climb while trimming the odd cells at either end of the range
+        float res = 0.0f;
+        for(size_t k = 0; first < last; k++, first = (first + 1) >> 1, last >>= 1)
+        {
+            if(first & 1) res = std::max(res, levels[k][first++]);
+            if(last & 1) res = std::max(res, levels[k][--last]);
+        }
+        return res;
+    }
+
+    inline int DepthBuffer::size() const
+    {
+        return levels.empty() ? 0 : int(levels[0].size());
+    }
+
+    inline void cullSprites(const RayCastable &viewer, const DepthBuffer &depth, const std::vector<Sprite> &sprites,
+                            std::vector<SpriteSpan> &visible, float nearest)
+    {
+        visible.clear();
+        const int columns = depth.size();
+        const Vector view = Vector::fromAngle(degToRad(viewer.rotation));
+
+        for(size_t i = 0; i < sprites.size(); i++)
+        {
+            const Sprite& sprite = sprites[i];
+            const Vector rel = sprite.pos - viewer.pos;
+            const float d = rel.dotProduct(view);
+            if(d < nearest) continue;
+
+            // the billboard always faces the viewer, so both edges are at its depth
+            const float side = rel.x * -view.y + rel.y * view.x;
+            const float left = viewer.projectToColumn(side - sprite.size * 0.5f, d);
+            const float rightEdge = viewer.projectToColumn(side + sprite.size * 0.5f, d);
+            int first = std::max(int(std::ceil(left)), 0);
+            int last = std::min(int(std::ceil(rightEdge)), columns);
+            if(first >= last) continue;
+
+            // hidden everywhere if even the farthest wall over it is in front
+            if(depth.farthest(first, last) <= d) continue;
+
+            // hidden columns at either end never reach the draw loop
+            while (depth.at(first) <= d) first++;
+            while (depth.at(last - 1) <= d) last--;
+            visible.push_back({ i, d, left, rightEdge - left, first, last });
+        }
+
+        static thread_local std::vector<SpriteSpan> scratch;
+        sortFarToNear(visible, scratch);
+    }
+
+    inline void sortFarToNear(std::vector<SpriteSpan> &spans, std::vector<SpriteSpan> &scratch)
+    {
+        // positive floats order like their bits, and depths are positive, so
+        // the flipped bits sort far to near. A byte per pass
+        auto key = [](const SpriteSpan& s) {
+            std::uint32_t bits;
+            std::memcpy(&bits, &s.depth, sizeof(bits));
+            return ~bits;
+        };
+
+        scratch.resize(spans.size());
+        for(int shift = 0; shift < 32; shift += 8)
+        {
+            size_t counts[256 + 1] = {};
+            for(const SpriteSpan& s: spans)
+                counts[((key(s) >> shift) & 255) + 1]++;
+
+            // every key has the same byte here, the pass would not move anything
+            if(std::find(counts + 1, counts + 257, spans.size()) != counts + 257) continue;
+
+            for(int d = 0; d < 256; d++)
+                counts[d + 1] += counts[d];
+            for(const SpriteSpan& s: spans)
+                scratch[counts[(key(s) >> shift) & 255]++] = s;
+            spans.swap(scratch);
+        }
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,465 @@
+/**
+ * @file rcc_stream.h
+ * @date 16-oct-2026
+ * Streaming maps too big to hold in memory. A ChunkStreamer keeps a budget
+ * of MapChunk resident, loads the ones around every castable on a thread of
+ * its own and drops the least recently used ones. World casts against
+ * whatever is resident; a ray that reaches a chunk still on its way stops
+ * there for the frame instead of waiting for the disk
+ */
+#ifndef __BYTENOL_RCC_STREAM_H__
+#define __BYTENOL_RCC_STREAM_H__
+
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rcc.h"
+#include "rcc_map.h"
+
+
+namespace rcc
+{
+
+    /// Where a ChunkStreamer gets its chunks from
+    class ChunkSource
+    {
+        public:
+            virtual ~ChunkSource() = default;
+
+            /// @brief Fill in the ids of a chunk, the occupancy is built from them.
+            /// Only ever called on the streaming thread, one chunk at a time
+            /// @param cx is the column of the chunk
+            /// @param cy is the row of the chunk
+            /// @param chunk receives the ids, tiles past the map can be anything
+            /// @return false if the chunk could not be read. It is never made
+            /// resident then, and rays keep stopping at it as at a chunk on its way
+            virtual bool loadChunk(int cx, int cy, MapChunk& chunk) = 0;
+    };
+
+
+    /// Tiles computed on the fly, for procedural worlds of any size
+    class GeneratedChunkSource : public ChunkSource
+    {
+        public:
+            /// @param tile gives the id of the tile at row y, column x
+            explicit GeneratedChunkSource(std::function<int(int y, int x)> tile);
+
+            bool loadChunk(int cx, int cy, MapChunk& chunk) override;
+
+        private:
+            std::function<int(int y, int x)> tile;
+    };
+
+
+    /// Chunks read from the ids layer of a map file, a row of a chunk per read.
+    /// Only the chunks asked for are ever read, however big the file is
+    class MapFileChunkSource : public ChunkSource
+    {
+        public:
+            /// @brief Open a map file, see rcc_map.h. The header and layer table
+            /// are checked the way MapFile::open checks them
+            /// @param path is the path to the file
+            /// @return false if the file could not be read, is not a valid map
+            /// file or has no ids layer, see getError()
+            bool open(const char* path);
+
+            bool loadChunk(int cx, int cy, MapChunk& chunk) override;
+
+            unsigned getCols() const;
+
+            unsigned getRows() const;
+
+            /// @brief Get why the last open() failed
+            const std::string& getError() const;
+
+        private:
+            bool fail(const std::string& why);
+
+            std::ifstream file;
+            std::string error;
+            std::uint64_t idsOffset = 0;
+            unsigned cols = 0;
+            unsigned rows = 0;
+    };
+
+
+    class ChunkStreamer
+    {
+        public:
+            /// @param source loads the chunks, it has to outlive the streamer
+            /// @param col is the size of the column in the map
+            /// @param row is the size of the row in the map
+            /// @param budget is the most chunks kept in memory at once
+            /// @param prefetchRadius is how many chunks around the chunk of every
+            /// castable are kept loaded, in every direction
+            ChunkStreamer(ChunkSource& source, unsigned col, unsigned row, size_t budget, int prefetchRadius = 1);
+            ~ChunkStreamer();
+
+            ChunkStreamer(const ChunkStreamer&) = delete;
+            ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+            /// @brief Make a world cast against the streamed chunks
+            void attach(World& world);
+
+            /// @brief Call once a frame before World::update(). Installs the chunks the
+            /// streaming thread finished, asks for the ones around every castable and
+            /// the ones rays stopped at last frame, and drops the least recently
+            /// used chunks over the budget. Never waits for a load
+            /// @param world is the world attach() was called with
+            void update(World& world);
+
+            /// @brief Wait until every chunk asked for is resident, for loading screens
+            /// and tests
+            /// @param world is the world attach() was called with
+            void flush(World& world);
+
+            bool isResident(int cx, int cy) const;
+
+            size_t getResidentCount() const;
+
+            /// @brief Get how many chunks update() installed since the streamer was made
+            size_t getLoadCount() const;
+
+            /// @brief Get how many chunks the source could not read. They are not
+            /// asked for again
+            size_t getFailedCount() const;
+
+        private:
+            void streamLoop();
+            bool load(size_t index, std::unique_ptr<MapChunk>& chunk);
+            void want(int cx, int cy, std::vector<size_t>& wanted) const;
+
+            ChunkSource& source;
+            unsigned cols = 0;
+            unsigned rows = 0;
+            int chunksX = 0;
+            int chunksY = 0;
+            size_t budget = 0;
+            int prefetchRadius = 0;
+
+            // only touched by update() and flush(), between frames
+            std::vector<const MapChunk*> table;               // what World reads
+            std::vector<std::unique_ptr<MapChunk>> owned;     // same indices as table
+            std::vector<unsigned> lastUsed;                   // frame a chunk was last wanted in
+            std::vector<size_t> resident;                     // indices of the resident chunks
+            std::vector<bool> failed;                         // the source could not read them
+            size_t failedCount = 0;
+            std::vector<size_t> wanted;
+            unsigned frame = 0;
+            size_t loadCount = 0;
+
+            // shared with the streaming thread
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable idle;
+            std::deque<size_t> queue;                                     // nearest first
+            std::vector<std::pair<size_t, std::unique_ptr<MapChunk>>> loaded;    // nullptr if the load failed
+            std::vector<std::unique_ptr<MapChunk>> spare;                 // evicted, for reuse
+            size_t loading = SIZE_MAX;
+            bool stopping = false;
+            std::thread streamer;
+    };
+
+
+    inline GeneratedChunkSource::GeneratedChunkSource(std::function<int(int y, int x)> tile)
+    {
+        this->tile = std::move(tile);
+    }
+
+    inline bool GeneratedChunkSource::loadChunk(int cx, int cy, MapChunk &chunk)
+    {
+        for(int y = 0; y < MapChunk::size; y++)
+            for(int x = 0; x < MapChunk::size; x++)
+                chunk.ids[y * MapChunk::size + x] = tile((cy << MapChunk::shift) + y, (cx << MapChunk::shift) + x);
+        return true;
+    }
+
+
+    inline bool MapFileChunkSource::open(const char *path)
+    {
+        file.close();
+        file.clear();
+        cols = rows = 0;
+        file.open(path, std::ios::binary | std::ios::ate);
+        if(!file) return fail(std::string("unable to open ") + path);
+        const std::uint64_t size = std::uint64_t(file.tellg());
+        file.seekg(0);
+
+        MapFileHeader header{};
+        std::string why;
+        if(size >= sizeof(header) && !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return fail(std::string("unable to read ") + path);
+        if(!checkMapFileHeader(header, size, why)) return fail(why);
+
+        bool hasIds = false;
+        for(std::uint32_t i = 0; i < header.layerCount; i++)
+        {
+            MapLayerEntry layer;
+            if(!file.read(reinterpret_cast<char*>(&layer), sizeof(layer))) return fail(std::string("unable to read ") + path);
+            if(!checkMapLayer(header, layer, i, size, why)) return fail(why);
+            if(layer.kind == std::uint32_t(MapLayer::Ids)) {
+                idsOffset = layer.offset;
+                hasIds = true;
+            }
+        }
+        if(!hasIds) return fail("no ids layer");
+
+        cols = header.cols;
+        rows = header.rows;
+        return true;
+    }
+
+    inline bool MapFileChunkSource::loadChunk(int cx, int cy, MapChunk &chunk)
+    {
+        std::fill(std::begin(chunk.ids), std::end(chunk.ids), 0);
+        const int x0 = cx << MapChunk::shift, y0 = cy << MapChunk::shift;
+        const int width = std::min<int>(MapChunk::size, int(cols) - x0);
+        for(int y = 0; y < MapChunk::size && y0 + y < int(rows); y++)
+        {
+            file.seekg(idsOffset + (std::uint64_t(y0 + y) * cols + x0) * sizeof(std::int32_t));
+            if(!file.read(reinterpret_cast<char*>(chunk.ids + y * MapChunk::size), width * sizeof(std::int32_t))) {
+                file.clear();   // the next chunk starts clean
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline unsigned MapFileChunkSource::getCols() const
+    {
+        return cols;
+    }
+
+    inline unsigned MapFileChunkSource::getRows() const
+    {
+        return rows;
+    }
+
+    inline const std::string &MapFileChunkSource::getError() const
+    {
+        return error;
+    }
+
+    inline bool MapFileChunkSource::fail(const std::string &why)
+    {
+        file.close();
+        cols = rows = 0;
+        error = why;
+        return false;
+    }
+
+
+    inline ChunkStreamer::ChunkStreamer(ChunkSource &source, unsigned col, unsigned row, size_t budget, int prefetchRadius)
+        : source(source)
+    {
+        chunksX = (col + MapChunk::size - 1) >> MapChunk::shift;
+        chunksY = (row + MapChunk::size - 1) >> MapChunk::shift;
+        this->budget = std::max<size_t>(budget, 1);
+        this->prefetchRadius = std::max(prefetchRadius, 0);
+        table.assign(size_t(chunksX) * chunksY, nullptr);
+        owned.resize(table.size());
+        lastUsed.assign(table.size(), 0);
+        failed.assign(table.size(), false);
+        cols = col;
+        rows = row;
+
+    #if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+        streamer = std::thread(&ChunkStreamer::streamLoop, this);
+    #endif
+    }
+
+    inline ChunkStreamer::~ChunkStreamer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if(streamer.joinable()) streamer.join();
+    }
+
+    inline void ChunkStreamer::attach(World &world)
+    {
+        world.setStreamedMap(table.data(), cols, rows);
+    }
+
+    inline void ChunkStreamer::update(World &world)
+    {
+        frame++;
+        bool changed = false;
+
+        // what each castable needs, its own chunk and then ring after ring
+        // around it, and where its rays ran into chunks that were missing
+        wanted.clear();
+        auto around = [&](const RayCastable& castable) {
+            const int cx = int(std::floor(castable.pos.x / world.getTileSize())) >> MapChunk::shift;
+            const int cy = int(std::floor(castable.pos.y / world.getTileSize())) >> MapChunk::shift;
+            for(int r = 0; r <= prefetchRadius; r++)
+                for(int y = cy - r; y <= cy + r; y++)
+                    for(int x = cx - r; x <= cx + r; x++)
+                        if(std::max(std::abs(x - cx), std::abs(y - cy)) == r) want(x, y, wanted);
+        };
+        auto stopped = [&](const RayCastable& castable) {
+            const RayBuffer& rays = castable.getRayBuffer();
+            for(size_t i = 0; i < rays.size(); i++)
+                if(rays.tileId[i] == World::unloadedTile)
+                    want(rays.cellX[i] >> MapChunk::shift, rays.cellY[i] >> MapChunk::shift, wanted);
+        };
+        if(world.getPlayer()) around(*world.getPlayer());
+        for(const RayCastable& castable: world.getCastables()) around(castable);
+        if(world.getPlayer()) stopped(*world.getPlayer());
+        for(const RayCastable& castable: world.getCastables()) stopped(castable);
+
+        // more than the budget can never be resident at once, the nearest win
+        if(wanted.size() > budget) wanted.resize(budget);
+        for(size_t index: wanted) lastUsed[index] = frame;
+
+        std::vector<std::pair<size_t, std::unique_ptr<MapChunk>>> arrived;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            arrived.swap(loaded);
+        }
+    #if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+        // no thread to stream on, load one chunk a frame instead
+        for(size_t index: wanted)
+            if(!owned[index] && !failed[index]) {
+                arrived.push_back({ index, nullptr });
+                if(!load(index, arrived.back().second)) arrived.back().second.reset();
+                break;
+            }
+    #endif
+
+        for(auto& [index, chunk]: arrived)
+        {
+            if(!chunk) {
+                failed[index] = true;
+                failedCount++;
+                continue;
+            }
+            if(owned[index]) continue;
+            table[index] = chunk.get();
+            owned[index] = std::move(chunk);
+            resident.push_back(index);
+            lastUsed[index] = std::max(lastUsed[index], frame - 1);
+            loadCount++;
+            changed = true;
+        }
+
+        // least recently used first; chunks wanted this frame stay, and since
+        // at most budget of them are wanted the loop always finds one to drop
+        std::vector<std::unique_ptr<MapChunk>> evicted;
+        while (resident.size() > budget)
+        {
+            auto oldest = std::min_element(resident.begin(), resident.end(), [&](size_t a, size_t b) { return lastUsed[a] < lastUsed[b]; });
+            if(lastUsed[*oldest] == frame) break;
+            table[*oldest] = nullptr;
+            evicted.push_back(std::move(owned[*oldest]));
+            *oldest = resident.back();
+            resident.pop_back();
+            changed = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.clear();
+            for(size_t index: wanted)
+                if(!owned[index] && !failed[index] && index != loading) queue.push_back(index);
+            for(auto& chunk: evicted)
+                if(spare.size() < 4) spare.push_back(std::move(chunk));
+        }
+        wake.notify_all();
+
+        if(changed) world.markMapChanged();
+    }
+
+    inline void ChunkStreamer::flush(World &world)
+    {
+        update(world);
+    #if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            idle.wait(lock, [&]() { return queue.empty() && loading == SIZE_MAX; });
+        }
+        update(world);
+    #else
+        for(size_t i = 0; i < budget; i++) update(world);
+    #endif
+    }
+
+    inline bool ChunkStreamer::isResident(int cx, int cy) const
+    {
+        if(cx < 0 || cy < 0 || cx >= chunksX || cy >= chunksY) return false;
+        return table[size_t(cy) * chunksX + cx] != nullptr;
+    }
+
+    inline size_t ChunkStreamer::getResidentCount() const
+    {
+        return resident.size();
+    }
+
+    inline size_t ChunkStreamer::getLoadCount() const
+    {
+        return loadCount;
+    }
+
+    inline size_t ChunkStreamer::getFailedCount() const
+    {
+        return failedCount;
+    }
+
+    inline void ChunkStreamer::streamLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            wake.wait(lock, [&]() { return stopping || !queue.empty(); });
+            if(stopping) return;
+
+            loading = queue.front();
+            queue.pop_front();
+            std::unique_ptr<MapChunk> chunk;
+            if(!spare.empty()) {
+                chunk = std::move(spare.back());
+                spare.pop_back();
+            }
+
+            lock.unlock();
+            const bool ok = load(loading, chunk);
+            lock.lock();
+
+            if(!ok) {
+                if(spare.size() < 4) spare.push_back(std::move(chunk));
+                chunk.reset();
+            }
+            loaded.push_back({ loading, std::move(chunk) });
+            loading = SIZE_MAX;
+            if(queue.empty()) idle.notify_all();
+        }
+    }
+
+    inline bool ChunkStreamer::load(size_t index, std::unique_ptr<MapChunk> &chunk)
+    {
+        if(!chunk) chunk = std::make_unique<MapChunk>();
+        if(!source.loadChunk(int(index % chunksX), int(index / chunksX), *chunk)) return false;
+        chunk->buildOccupancy();
+        return true;
+    }
+
+    inline void ChunkStreamer::want(int cx, int cy, std::vector<size_t> &wanted) const
+    {
+        if(cx < 0 || cy < 0 || cx >= chunksX || cy >= chunksY) return;
+        const size_t index = size_t(cy) * chunksX + cx;
+        if(std::find(wanted.begin(), wanted.end(), index) == wanted.end()) wanted.push_back(index);
+    }
+
+}
+
+
+#endif
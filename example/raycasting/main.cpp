@@ -3,8 +3,17 @@
 #include <memory>
 #include <vector>
 #include <cmath>
+#include <thread>
 
+#include <dl2hub/fixed_timestep.h>
+#include <dl2hub/framebuffer.h>
+#include <dl2hub/profiler.h>
+#include <dl2hub/texture_atlas.h>
+
+#define RCC_PROFILE_SCOPE DL2HUB_PROFILE_SCOPE
+#define RCC_THREAD_NAME DL2HUB_TRACE_THREAD_NAME
 #include "./include/rcc.h"
+#include "./include/rcc_sprite.h"
 
 
 struct {
@@ -15,6 +24,8 @@ struct {
 
 
 std::unique_ptr<rcc::World> world;
+dl2hub::Framebuffer frame;
+dl2hub::TextureAtlas wallTextures;
 
 std::vector<int> levelMap {
     1,1,1,1,1,1,1,1,
@@ -30,6 +41,45 @@ std::vector<int> levelMap {
 
 rcc::RayCastable player;
 
+// the other castables seen from the player, rebuilt every frame
+rcc::DepthBuffer playerDepth;
+std::vector<rcc::Sprite> sprites;
+std::vector<rcc::SpriteSpan> visibleSprites;
+
+// walls farther than this are not drawn, and it sets the scale of the view
+const float maxDist = 200.0f;
+const float playerFov = 60.0f;
+
+// atlas tiles for the floor and ceiling, the checker board and the bricks
+const int floorTile = 1;
+const int ceilingTile = 0;
+
+
+/// @brief Build a strip of two 64x64 wall tiles, bricks and a checker board,
+/// used when there is no walls.bmp next to the executable
+SDL_Surface* createDefaultWallTextures()
+{
+    const int size = 64;
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size * 2, size, 32, SDL_PIXELFORMAT_ARGB8888);
+    if(!surface) return nullptr;
+
+    Uint32* pixels = static_cast<Uint32*>(surface->pixels);
+    const int pitch = surface->pitch / sizeof(Uint32);
+    for(int y = 0; y < size; y++)
+    {
+        for(int x = 0; x < size; x++)
+        {
+            const int row = y / 16;
+            const bool mortar = y % 16 == 0 || (x + (row % 2) * 16) % 32 == 0;
+            pixels[y * pitch + x] = mortar ? 0xff9a9a9a : 0xffa03c28;
+
+            const bool dark = (x / 8 + y / 8) % 2;
+            pixels[y * pitch + size + x] = dark ? 0xff2850a0 : 0xffd0d0d0;
+        }
+    }
+    return surface;
+}
+
 
 void init()
 {
@@ -40,9 +90,10 @@ void init()
     world = rcc::createWorld(64, worldSize);
     world->setWorldInfo(levelMap, 8, 8);
     world->setPlayer(player);
+    world->setWorkerCount(std::max(1u, std::thread::hardware_concurrency()) - 1);
 
     // setup and initialize player
-    player = rcc::RayCastable(60.0f, 0.0f, world->getSize().x);
+    player = rcc::RayCastable(playerFov, 0.0f, world->getSize().x, rcc::Projection::CameraPlane);
     player.pos.x = 276.0f;
     player.pos.y = 276.0f;
 
@@ -55,119 +106,174 @@ void init()
     g.pos.x = 80;
     g.pos.y = 280;
     world->addCastable(g);
+
+    if(!frame.create(canvas.renderer, canvas.w, canvas.h))
+        std::cerr << "Unable to create framebuffer: " << SDL_GetError() << std::endl;
+
+    if(!wallTextures.load("walls.bmp")) {
+        SDL_Surface* surface = createDefaultWallTextures();
+        if(!surface || !wallTextures.loadSurface(surface))
+            std::cerr << "Unable to create wall textures: " << SDL_GetError() << std::endl;
+        SDL_FreeSurface(surface);
+    }
+
+    // the first advance() of the timestep runs no update, cast once so the
+    // first frame has rays to draw
+    world->update(0.0f);
 }
 
 void update(float dt)
 {
+    DL2HUB_PROFILE_SCOPE("update");
     // player.castRay(*world);
     world->update(dt);
 }
 
 
-void render(SDL_Renderer* renderer)
+/// @brief Draw a castable's marker and rays on the minimap, and its view as
+/// wall slices along the left edge of the frame
+void drawCastable(const rcc::RayCastable& castable, const rcc::Vector& minMapPos)
 {
+    int size = world->getTileSize() * 0.1;
+    int px = castable.pos.x - size * 0.5;
+    int py = castable.pos.y - size * 0.5;
+    frame.fillRect({ int(minMapPos.x + px), int(minMapPos.y + py), size, size }, dl2hub::Framebuffer::color(0x00, 0x00, 0xff));
 
-    auto minMapPos = rcc::Vector{ world->getSize().x, 0 };
+    const Uint32 rayColor = dl2hub::Framebuffer::color(0xff, 0x00, 0x00);
 
-    // render minMap
-    for(size_t i = 0; i < world->getRowSize(); i++) 
+    const auto& rays = castable.getRayBuffer();
+    for(size_t i = 0; i < rays.size(); i++)
     {
-        for(size_t j = 0; j < world->getColSize(); j++)
-        {
-            const int& id = world->getMapId(i, j);
-            int px = minMapPos.x + j * world->getTileSize();
-            int py = minMapPos.y + i * world->getTileSize();
-            SDL_Rect rect{ px, py, world->getTileSize(), world->getTileSize() };
+        if(rays.dist[i] < maxDist) {
+            float h = (maxDist / rays.dist[i]) * 64;
+            float py = world->getSize().y * 0.5 - h * 0.5;
 
-            if(id == 0) {
-                // SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
-                // SDL_RenderFillRect(renderer, &rect);
-                // SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xff);
-                // SDL_RenderDrawRect(renderer, &rect);
-            } else {
-                SDL_SetRenderDrawColor(renderer, 0x00, 0xff, 0x00, 0xff);
-                SDL_RenderFillRect(renderer, &rect);
-                SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xff);
-                SDL_RenderDrawRect(renderer, &rect);
-            }
+            // tile ids start at 1, the first texture is for id 1
+            const Uint32* texels = wallTextures.getColumn(rays.tileId[i] - 1, rays.wallX[i]);
+            frame.drawTexturedColumn(i, py, h, texels, wallTextures.getTileSize(), !rays.isVert[i]);
         }
+
+        frame.drawLine(minMapPos.x + castable.pos.x, minMapPos.y + castable.pos.y, 
+            minMapPos.x + rays.hitX[i], minMapPos.y + rays.hitY[i], rayColor);
     }
+}
 
-    // render player
-    for(auto entity = world->getCastables().begin(); entity != world->getCastables().end(); entity++)
+
+/// @brief Texture the floor and ceiling of the player's view a row at a time.
+/// Walls are drawn over it afterwards
+void drawFloorAndCeiling()
+{
+    const Uint32* floorTexels = wallTextures.getTile(floorTile);
+    const Uint32* ceilingTexels = wallTextures.getTile(ceilingTile);
+    if(!floorTexels) return;
+
+    // the view is a camera plane, so the floor seen along a row is a straight
+    // line in the world at one depth: the points under the columns are evenly
+    // spaced, and a row costs one division instead of one per pixel
+    const int viewW = int(player.getRayBuffer().size());
+    const int viewH = int(world->getSize().y);
+    const float horizon = viewH * 0.5f;
+    const rcc::Vector view = rcc::Vector::fromAngle(rcc::degToRad(player.rotation));
+    const rcc::Vector plane = rcc::Vector{ -view.y, view.x } * std::tan(rcc::degToRad(playerFov / 2));
+    const rcc::Vector leftDir = view - plane;
+    const rcc::Vector columnStep = plane * (2.0f / viewW);
+
+    // walls are 64 units tall and drawn maxDist / dist * 64 pixels high around
+    // the horizon, so the eye is 32 units up and a row p pixels off the
+    // horizon sees the floor at 32 * maxDist / p
+    const float texelsPerUnit = float(wallTextures.getTileSize()) / world->getTileSize();
+    const int texSize = wallTextures.getTileSize();
+    for(int y = int(std::ceil(horizon)); y < viewH; y++)
     {
-        int entitySize = world->getTileSize() * 0.1;
-        int px = entity->pos.x - entitySize * 0.5;
-        int py = entity->pos.y - entitySize * 0.5;
-        SDL_Rect rect{ int(minMapPos.x + px), int(minMapPos.y + py), entitySize, entitySize};
-        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0xff, 0xff);
-        SDL_RenderFillRect(renderer, &rect);
-
-        const auto& rays = entity->getRays();
-        SDL_SetRenderDrawColor(renderer, 0xff, 0x00, 0x00, 0xff);
-        int i = 0;
-        float maxDist = 200.0f;
-        for(auto it = rays.begin(); it != rays.end(); it++)
-        {
-            if(it->dist < maxDist) {
-                float h = (maxDist / it->dist) * 64;
-                float py = world->getSize().y * 0.5 - h * 0.5;
+        const float rowDist = 32.0f * maxDist / (y + 0.5f - horizon);
+        const rcc::Vector start = player.pos + leftDir * rowDist;
+        const rcc::Vector step = columnStep * (rowDist * texelsPerUnit);
+        const float u = start.x * texelsPerUnit, v = start.y * texelsPerUnit;
+
+        // the ceiling mirrors the floor around the horizon
+        frame.drawTexturedRow(y, 0, viewW, u, v, step.x, step.y, floorTexels, texSize);
+        frame.drawTexturedRow(viewH - 1 - y, 0, viewW, u, v, step.x, step.y, ceilingTexels, texSize, true);
+    }
+}
 
-                SDL_SetRenderDrawColor(renderer, 0x00, 0x32, 0xaa, 0xff);
-                SDL_RenderDrawLineF(renderer, i, 0, i, py);
 
-                if(it->isVert) SDL_SetRenderDrawColor(renderer, 0xff, 0x00, 0x00, 0xff);
-                else SDL_SetRenderDrawColor(renderer, 0xaa, 0x00, 0x00, 0xff);
-                SDL_RenderDrawLineF(renderer, i, py, i, h);
-            }
-            
-            i++;
+/// @brief Draw the other castables as billboards in the player's view, standing
+/// on the same floor line as the walls and hidden by walls in front of them
+void drawSprites()
+{
+    sprites.clear();
+    for(const auto& castable: world->getCastables())
+        sprites.push_back({ castable.pos, world->getTileSize() * 0.5f });
 
-            SDL_SetRenderDrawColor(renderer, 0xff, 0x00, 0x00, 0xff);
-            SDL_RenderDrawLineF(renderer, minMapPos.x + it->start.x, minMapPos.y + it->start.y, 
-                minMapPos.x + it->end.x, minMapPos.y + it->end.y);
+    playerDepth.build(player.getRayBuffer());
+    rcc::cullSprites(player, playerDepth, sprites, visibleSprites);
+
+    const Uint32 spriteColor = dl2hub::Framebuffer::color(0x00, 0x00, 0xff);
+    for(const auto& span: visibleSprites)
+    {
+        if(span.depth >= maxDist) continue;
+        const float wallH = (maxDist / span.depth) * 64;
+        const float h = (maxDist / span.depth) * sprites[span.sprite].size;
+        const float bottom = world->getSize().y * 0.5 + wallH * 0.5;
+        const float centre = bottom - h * 0.5f;
+
+        // a round billboard: each column is as tall as the circle is there
+        for(int x = span.first; x < span.last; x++)
+        {
+            if(playerDepth.at(x) <= span.depth) continue;
+            const float u = (x + 0.5f - span.left) / span.width * 2.0f - 1.0f;
+            if(u <= -1.0f || u >= 1.0f) continue;
+            const float halfH = h * 0.5f * std::sqrt(1.0f - u * u);
+            frame.drawColumn(x, centre - halfH, centre + halfH, spriteColor);
         }
     }
+}
 
-    int playerSize = world->getTileSize() * 0.1;
-    int px = player.pos.x - playerSize * 0.5;
-    int py = player.pos.y - playerSize * 0.5;
-    SDL_Rect rect{ int(minMapPos.x + px), int(minMapPos.y + py), playerSize, playerSize};
-    SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0xff, 0xff);
-    SDL_RenderFillRect(renderer, &rect);
-
-    const auto& rays = player.getRays();
-    SDL_SetRenderDrawColor(renderer, 0xff, 0x00, 0x00, 0xff);
-    int i = 0;
-    float maxDist = 200.0f;
-    for(auto it = rays.begin(); it != rays.end(); it++)
-    {
-        if(it->dist < maxDist) {
-            float h = (maxDist / it->dist) * 64;
-            float py = world->getSize().y * 0.5 - h * 0.5;
 
-            SDL_SetRenderDrawColor(renderer, 0x00, 0x32, 0xaa, 0xff);
-            SDL_RenderDrawLineF(renderer, i, 0, i, py);
+void render(SDL_Renderer* renderer)
+{
+    DL2HUB_PROFILE_SCOPE("render");
+    // the whole frame is drawn on the cpu and copied to the screen at once
+    if(!frame.lock()) return;
+    frame.clear(dl2hub::Framebuffer::color(0x00, 0x00, 0x00));
 
-            if(it->isVert) SDL_SetRenderDrawColor(renderer, 0xff, 0x00, 0x00, 0xff);
-            else SDL_SetRenderDrawColor(renderer, 0xaa, 0x00, 0x00, 0xff);
-            SDL_RenderDrawLineF(renderer, i, py, i, h);
-        }
-        
-        i++;
+    auto minMapPos = rcc::Vector{ world->getSize().x, 0 };
+
+    // render minMap
+    const Uint32 wallColor = dl2hub::Framebuffer::color(0x00, 0xff, 0x00);
+    const Uint32 outlineColor = dl2hub::Framebuffer::color(0x00, 0x00, 0x00);
+    for(int i = 0; i < world->getRowSize(); i++)
+    {
+        for(int j = 0; j < world->getColSize(); j++)
+        {
+            const int& id = world->getMapId(i, j);
+            int px = minMapPos.x + j * world->getTileSize();
+            int py = minMapPos.y + i * world->getTileSize();
+            SDL_Rect rect{ px, py, world->getTileSize(), world->getTileSize() };
 
-        SDL_SetRenderDrawColor(renderer, 0xff, 0x00, 0x00, 0xff);
-        SDL_RenderDrawLineF(renderer, minMapPos.x + it->start.x, minMapPos.y + it->start.y, 
-            minMapPos.x + it->end.x, minMapPos.y + it->end.y);
+            if(id != 0) {
+                frame.fillRect(rect, wallColor);
+                frame.drawRect(rect, outlineColor);
+            }
+        }
     }
 
-    SDL_SetRenderDrawColor(renderer, 0xff, 0x00, 0x00, 0xff);
-    SDL_RenderDrawLine(renderer, 0, world->getSize().y, world->getSize().x, world->getSize().y);
+    // render player
+    drawFloorAndCeiling();
+    for(auto entity = world->getCastables().begin(); entity != world->getCastables().end(); entity++)
+        drawCastable(*entity, minMapPos);
+    drawCastable(player, minMapPos);
+    drawSprites();
+
+    frame.fillRect({ 0, int(world->getSize().y), int(world->getSize().x) + 1, 1 }, dl2hub::Framebuffer::color(0xff, 0x00, 0x00));
+    frame.present(renderer);
 }
 
 
 void processEvent(SDL_Event& evt, bool& shouldClose)
 {
+    DL2HUB_PROFILE_SCOPE("events");
+    if(dl2hub::Profiler::get().handleEvent(evt)) return;
     if(evt.type == SDL_QUIT) {
         shouldClose = true;
         return;
@@ -203,6 +309,7 @@ void processEvent(SDL_Event& evt, bool& shouldClose)
 
 void mainLoop()
 {
+    dl2hub::FixedTimestep timestep;
     bool shouldQuit = false;
     SDL_Event evt;
 
@@ -210,12 +317,17 @@ void mainLoop()
     {
         while (SDL_PollEvent(&evt))
             processEvent(evt, shouldQuit);
+        timestep.advance(update);
         
         SDL_SetRenderDrawColor(canvas.renderer, 0x00, 0x00, 0x00, 0x00);
         SDL_RenderClear(canvas.renderer);
         render(canvas.renderer);
-        update(1 / 60.0f);
-        SDL_RenderPresent(canvas.renderer);
+        dl2hub::Profiler::get().drawHud(canvas.renderer);
+        {
+            DL2HUB_PROFILE_SCOPE("present");
+            SDL_RenderPresent(canvas.renderer);
+        }
+        dl2hub::Profiler::get().endFrame();
     }
     
 }
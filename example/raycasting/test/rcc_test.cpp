@@ -0,0 +1,695 @@
+/**
+ * @file rcc_test.cpp
+ * @date 16-oct-2026
+ * Checks for the rcc ray caster that need no window. Returns non zero
+ * and prints the failing case when a check does not hold.
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "../include/rcc.h"
+#include "../include/rcc_map.h"
+#include "../include/rcc_stream.h"
+#include "../include/rcc_sprite.h"
+
+
+int failures = 0;
+
+void check(bool ok, const std::string& what)
+{
+    if(ok) return;
+    failures++;
+    std::cerr << "FAILED: " << what << std::endl;
+}
+
+
+/// @brief n*n map with a solid border and random pillars inside
+std::vector<int> makeMap(int n, float density, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    std::vector<int> map(n * n, 0);
+    for(int y = 0; y < n; y++)
+        for(int x = 0; x < n; x++) {
+            const bool border = x == 0 || y == 0 || x == n - 1 || y == n - 1;
+            map[y * n + x] = border || dis(gen) < density ? 1 : 0;
+        }
+    return map;
+}
+
+
+// The fixed point traversal has to stop within one tile of where the float
+// traversal stops. The one exception is a ray that grazes the corner of a wall:
+// rounding the direction to 16.16 may slip it past the corner, so there the
+// fixed point hit only has to lie on the float ray, within one tile of it
+void testFixedPointWithinOneTile()
+{
+    const int tileSize = 64;
+    const struct { int n; float density; } maps[] = { { 8, 0.2f }, { 64, 0.05f }, { 512, 0.002f } };
+    const rcc::Projection projections[] = { rcc::Projection::Angular, rcc::Projection::CameraPlane };
+
+    std::mt19937 gen(11);
+    for(const auto& m: maps)
+    {
+        auto map = makeMap(m.n, m.density, m.n);
+        auto world = rcc::createWorld(tileSize, rcc::Vector{ 640, 480 });
+        world->setWorldInfo(map, m.n, m.n);
+
+        std::uniform_real_distribution<float> coord(1.0f, m.n - 1.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+        for(auto projection: projections)
+        {
+            rcc::RayCastable real(60.0f, 0.0f, 320, projection);
+            for(int pose = 0; pose < 50; pose++)
+            {
+                real.pos = rcc::Vector{ coord(gen) * tileSize, coord(gen) * tileSize };
+                if(world->getMapId(real.pos.y / tileSize, real.pos.x / tileSize) != 0) continue;
+                real.rotation = angle(gen);
+                rcc::RayCastable fixed = real;
+
+                const size_t rays = real.getRayBuffer().size();
+                real.castRayAs<float>(*world, 0, rays);
+                fixed.castRayAs<rcc::Fixed>(*world, 0, rays);
+
+                const auto& a = real.getRayBuffer();
+                const auto& b = fixed.getRayBuffer();
+                for(size_t i = 0; i < rays; i++)
+                {
+                    const float dx = b.hitX[i] - a.hitX[i];
+                    const float dy = b.hitY[i] - a.hitY[i];
+                    const bool close = std::abs(dx) <= tileSize && std::abs(dy) <= tileSize &&
+                                       std::abs(a.dist[i] - b.dist[i]) <= tileSize;
+
+                    // both directions are rounded to 2^-16, so the rays drift apart
+                    // by well under 2^-12 tiles per tile travelled
+                    const float along = a.dist[i] / tileSize;
+                    const float margin = (along + 1.0f) / 4096.0f;
+                    const bool grazing = a.wallX[i] < margin || a.wallX[i] > 1.0f - margin;
+                    const float dirX = a.hitX[i] - real.pos.x, dirY = a.hitY[i] - real.pos.y;
+                    const float offRay = std::abs(dx * dirY - dy * dirX) / std::hypot(dirX, dirY);
+
+                    check(close || (grazing && offRay <= tileSize),
+                          "fixed point hit of ray " + std::to_string(i) + " in a " +
+                          std::to_string(m.n) + "^2 map at (" + std::to_string(real.pos.x) + ", " +
+                          std::to_string(real.pos.y) + ") facing " + std::to_string(real.rotation));
+                }
+            }
+        }
+    }
+}
+
+
+// update() has to skip exactly the castables whose pose and map did not
+// change, and what it keeps has to match a fresh cast
+void testUpdateSkipsUnchangedCastables()
+{
+    const int n = 16;
+    auto map = makeMap(n, 0.1f, 5);
+    auto world = rcc::createWorld(64, rcc::Vector{ 640, 480 });
+    world->setWorldInfo(map, n, n);
+
+    rcc::RayCastable player(60.0f, 0.0f, 64);
+    player.pos = rcc::Vector{ 1.5f * 64, 1.5f * 64 };
+    world->setPlayer(player);
+    for(int i = 0; i < 3; i++) {
+        rcc::RayCastable guard(45.0f, i * 90.0f, 8);
+        guard.pos = rcc::Vector{ (2.5f + i) * 64, 1.5f * 64 };
+        world->addCastable(guard);
+    }
+
+    auto sameAsFresh = [&](const rcc::RayCastable& castable) {
+        rcc::RayCastable fresh = castable;
+        fresh.castRay(*world);
+        const auto& a = castable.getRayBuffer();
+        const auto& b = fresh.getRayBuffer();
+        for(size_t i = 0; i < a.size(); i++)
+            if(a.dist[i] != b.dist[i] || a.cellX[i] != b.cellX[i] || a.cellY[i] != b.cellY[i]) return false;
+        return true;
+    };
+
+    world->update(0.0f);
+    check(world->getSkippedCasts() == 0, "first update casts everything");
+
+    world->update(0.0f);
+    check(world->getSkippedCasts() == 4, "nothing moved, everything skipped");
+
+    player.rotation += 5.0f;
+    world->getCastables()[1].pos.x += 3.0f;
+    world->update(0.0f);
+    check(world->getSkippedCasts() == 2, "only the moved castables are cast");
+    check(sameAsFresh(player) && sameAsFresh(world->getCastables()[1]), "moved castables have fresh rays");
+
+    map[1 * n + 2] = 1 - map[1 * n + 2];
+    world->markMapChanged();
+    world->update(0.0f);
+    check(world->getSkippedCasts() == 0, "a map change casts everything");
+    for(const auto& c: world->getCastables())
+        check(sameAsFresh(c), "castables see the changed map");
+}
+
+
+// turning by whole columns shifts the old rays over, the result has to match
+// a fresh cast up to float rounding of the ray directions
+void testTurnReusesColumns()
+{
+    const int n = 32;
+    auto map = makeMap(n, 0.08f, 9);
+    auto world = rcc::createWorld(64, rcc::Vector{ 640, 480 });
+    world->setWorldInfo(map, n, n);
+
+    const int columns = 240;
+    const float fov = 60.0f;
+    rcc::RayCastable player(fov, 10.0f, columns);
+    player.pos = rcc::Vector{ 15.3f * 64, 16.7f * 64 };
+    map[16 * n + 15] = 0;
+    world->setPlayer(player);
+    world->update(0.0f);
+
+    const float step = fov / columns;
+    const float turns[] = { 7 * step, -19.0004f * step, 0.5f * step, 300 * step };
+    const size_t shifted[] = { 1, 1, 0, 0 };
+    for(size_t t = 0; t < std::size(turns); t++)
+    {
+        player.rotation += turns[t];
+        world->update(0.0f);
+        check(world->getShiftedCasts() == shifted[t], "turn " + std::to_string(t) + " reuses columns when it should");
+        if(shifted[t]) {
+            world->update(0.0f);
+            check(world->getSkippedCasts() == 1, "turn " + std::to_string(t) + " is not cast again once it stops");
+        }
+
+        rcc::RayCastable fresh = player;
+        fresh.castRay(*world);
+        const auto& a = player.getRayBuffer();
+        const auto& b = fresh.getRayBuffer();
+        for(size_t i = 0; i < a.size(); i++)
+        {
+            const bool same = a.cellX[i] == b.cellX[i] && a.cellY[i] == b.cellY[i] &&
+                              std::abs(a.dist[i] - b.dist[i]) <= 1e-3f * b.dist[i];
+            check(same, "ray " + std::to_string(i) + " after turn " + std::to_string(t) + " matches a fresh cast");
+        }
+    }
+
+    // turns a fraction of a column off every frame, slow ones and near whole
+    // ones back and forth, must not drift from where the player looks
+    const float slowTurns[][2] = { { 0.0005f * step, 0.0005f * step }, { 1.0005f * step, -0.9995f * step } };
+    for(const auto& turn: slowTurns)
+    {
+        for(int frame = 0; frame < 20000; frame++)
+        {
+            player.rotation += turn[frame % 2];
+            world->update(0.0f);
+        }
+
+        rcc::RayCastable fresh = player;
+        fresh.castRay(*world);
+        const auto& a = player.getRayBuffer();
+        const auto& b = fresh.getRayBuffer();
+        size_t mismatches = 0;
+        for(size_t i = 0; i < a.size(); i++)
+            mismatches += a.cellX[i] != b.cellX[i] || a.cellY[i] != b.cellY[i];
+        check(mismatches == 0, "turns of " + std::to_string(turn[0] / step) + " and " + std::to_string(turn[1] / step) + " columns match a fresh cast");
+    }
+}
+
+
+// block jumps add up tDelta in bigger steps than single cell steps do, so a
+// float ray grazing a corner may pass it on one path and stop on the other.
+// Every other ray has to stop in the same cell
+void testAccelerationMatchesCellWalk()
+{
+    const int tileSize = 64;
+    const struct { int n; float density; } maps[] = { { 64, 0.2f }, { 1024, 0.001f } };
+    const rcc::Acceleration modes[] = { rcc::Acceleration::Pyramid, rcc::Acceleration::DistanceField };
+
+    std::mt19937 gen(13);
+    for(const auto& m: maps)
+    {
+        auto map = makeMap(m.n, m.density, m.n + 1);
+        auto world = rcc::createWorld(tileSize, rcc::Vector{ 640, 480 });
+        world->setWorldInfo(map, m.n, m.n);
+
+        std::uniform_real_distribution<float> coord(1.0f, m.n - 1.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+        for(int pose = 0; pose < 20; pose++)
+        {
+            rcc::RayCastable walk(60.0f, angle(gen), 320);
+            walk.pos = rcc::Vector{ coord(gen) * tileSize, coord(gen) * tileSize };
+            if(world->getMapId(walk.pos.y / tileSize, walk.pos.x / tileSize) != 0) continue;
+            rcc::RayCastable fixedWalk = walk;
+
+            world->setAcceleration(rcc::Acceleration::None);
+            walk.castRayAs<float>(*world, 0, 320);
+            fixedWalk.castRayAs<rcc::Fixed>(*world, 0, 320);
+            const auto& a = walk.getRayBuffer();
+            const auto& fa = fixedWalk.getRayBuffer();
+
+            for(auto mode: modes)
+            {
+                rcc::RayCastable jump = walk, fixedJump = walk;
+                world->setAcceleration(mode);
+                jump.castRayAs<float>(*world, 0, 320);
+                fixedJump.castRayAs<rcc::Fixed>(*world, 0, 320);
+
+                const auto& b = jump.getRayBuffer();
+                const auto& fb = fixedJump.getRayBuffer();
+                const std::string where = " in a " + std::to_string(m.n) + "^2 map, mode " + std::to_string(int(mode));
+                for(size_t i = 0; i < a.size(); i++)
+                {
+                    const bool same = a.cellX[i] == b.cellX[i] && a.cellY[i] == b.cellY[i] && a.isVert[i] == b.isVert[i];
+                    const float margin = (a.dist[i] / tileSize + 1.0f) / 4096.0f;
+                    auto grazing = [&](float wallX) { return wallX < margin || wallX > 1.0f - margin; };
+                    check(same || grazing(a.wallX[i]) || grazing(b.wallX[i]), "ray " + std::to_string(i) + where);
+
+                    // integer tDelta sums are exact, fixed point has no such excuse
+                    check(fa.cellX[i] == fb.cellX[i] && fa.cellY[i] == fb.cellY[i] && fa.isVert[i] == fb.isVert[i],
+                          "fixed point ray " + std::to_string(i) + where);
+                }
+            }
+        }
+    }
+}
+
+
+// the two pass distance field against a brute force search
+void testDistanceField()
+{
+    const int cols = 37, rows = 23;
+    std::mt19937 gen(6);
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    std::vector<int> map(cols * rows);
+    for(auto& id: map) id = dis(gen) < 0.03f ? 2 : 0;
+
+    auto world = rcc::createWorld(64, rcc::Vector{ 640, 480 });
+    world->setWorldInfo(map, cols, rows);
+    world->setAcceleration(rcc::Acceleration::DistanceField);
+
+    for(int y = 0; y < rows; y++)
+        for(int x = 0; x < cols; x++)
+        {
+            // the nearest solid tile or the first cell past the edge
+            int expected = std::min({ x + 1, y + 1, cols - x, rows - y });
+            for(int sy = 0; sy < rows; sy++)
+                for(int sx = 0; sx < cols; sx++)
+                    if(map[sy * cols + sx] != 0)
+                        expected = std::min(expected, std::max(std::abs(sx - x), std::abs(sy - y)));
+            check(world->getClearance(y, x) == expected,
+                  "clearance of (" + std::to_string(x) + ", " + std::to_string(y) + ")");
+        }
+}
+
+
+// the occupancy bitmap has to agree with the ids on every cell in every layout,
+// including rows that end partway into a word or block and cells just outside
+// the map, before and after single tiles change
+void testOccupancyBitmap()
+{
+    const int cols = 70, rows = 9;
+    const std::pair<rcc::MapLayout, std::string> layouts[] = {
+        { rcc::MapLayout::RowMajor, "row major" },
+        { rcc::MapLayout::Tiled, "tiled" },
+        { rcc::MapLayout::Morton, "morton" },
+    };
+
+    for(const auto& [layout, name]: layouts)
+    {
+        std::mt19937 gen(8);
+        std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+        std::vector<int> map(cols * rows);
+        for(auto& id: map) id = dis(gen) < 0.3f ? int(dis(gen) * 5) : 0;
+
+        auto world = rcc::createWorld(64, rcc::Vector{ 640, 480 });
+        world->setMapLayout(layout);
+        world->setWorldInfo(map, cols, rows);
+
+        auto compare = [&](const std::string& when) {
+            for(int y = -1; y <= rows; y++)
+                for(int x = -1; x <= cols; x++)
+                    check(world->isSolid(y, x) == (world->getMapId(y, x) != 0),
+                          name + " occupancy of (" + std::to_string(x) + ", " + std::to_string(y) + ") " + when);
+        };
+        compare("after setWorldInfo");
+
+        std::uniform_int_distribution<int> col(0, cols - 1), row(0, rows - 1);
+        for(int edit = 0; edit < 200; edit++)
+        {
+            const int y = row(gen), x = col(gen);
+            map[y * cols + x] = edit % 2 ? 3 : 0;
+            world->markTileChanged(y, x);
+        }
+        compare("after tile edits");
+    }
+}
+
+
+// the layout only changes where bits are stored, every ray has to stop in the
+// same cell at the same distance
+void testLayoutsCastAlike()
+{
+    const int cols = 131, rows = 77;
+    std::vector<int> map(cols * rows);
+    std::mt19937 gen(12);
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    for(auto& id: map) id = dis(gen) < 0.02f ? 1 : 0;
+
+    auto world = rcc::createWorld(64, rcc::Vector{ 640, 480 });
+    world->setWorldInfo(map, cols, rows);
+
+    rcc::RayCastable rowMajor(360.0f, 0.0f, 720);
+    rowMajor.pos = rcc::Vector{ 40.5f * 64, 30.25f * 64 };
+    rowMajor.castRay(*world);
+
+    for(const rcc::MapLayout layout: { rcc::MapLayout::Tiled, rcc::MapLayout::Morton })
+    {
+        world->setMapLayout(layout);
+        rcc::RayCastable other = rowMajor;
+        other.castRay(*world);
+        const auto& a = rowMajor.getRayBuffer();
+        const auto& b = other.getRayBuffer();
+        for(size_t i = 0; i < a.size(); i++)
+            check(a.cellX[i] == b.cellX[i] && a.cellY[i] == b.cellY[i] && a.dist[i] == b.dist[i],
+                  "ray " + std::to_string(i) + " in layout " + std::to_string(int(layout)));
+    }
+}
+
+
+// the packet caster has to stop in exactly the cells the scalar caster does,
+// in every layout and whatever acceleration the scalar caster takes
+void testPacketsMatchScalar()
+{
+    const int n = 96;
+    auto map = makeMap(n, 0.05f, 21);
+    map[30 * n + 40] = map[1 * n + 1] = map[88 * n + 70] = 0;
+    auto world = rcc::createWorld(64, rcc::Vector{ 640, 480 });
+    world->setWorldInfo(map, n, n);
+
+    const rcc::MapLayout layouts[] = { rcc::MapLayout::RowMajor, rcc::MapLayout::Tiled, rcc::MapLayout::Morton };
+    const rcc::Acceleration modes[] = { rcc::Acceleration::None, rcc::Acceleration::Pyramid, rcc::Acceleration::DistanceField };
+    const rcc::Projection projections[] = { rcc::Projection::Angular, rcc::Projection::CameraPlane };
+
+    // a ray count that is no multiple of the packet width leaves rays for the fallback
+    const int columns = 643;
+    const rcc::Vector starts[] = { { 40.5f * 64, 30.25f * 64 }, { 1.5f * 64, 1.5f * 64 }, { 70.1f * 64, 88.9f * 64 } };
+    for(const rcc::Vector& start: starts)
+    {
+        for(const auto layout: layouts)
+        for(const auto mode: modes)
+        for(const auto projection: projections)
+        {
+            world->setMapLayout(layout);
+            world->setAcceleration(mode);
+            for(float rotation = 0.0f; rotation < 360.0f; rotation += 37.5f)
+            {
+                rcc::RayCastable scalar(75.0f, rotation, columns, projection);
+                scalar.pos = start;
+                rcc::RayCastable packets = scalar;
+                scalar.castRay(*world);
+                packets.castRayPackets(*world, 0, columns);
+
+                const auto& a = scalar.getRayBuffer();
+                const auto& b = packets.getRayBuffer();
+                size_t mismatches = 0;
+                for(size_t i = 0; i < a.size(); i++)
+                    mismatches += a.cellX[i] != b.cellX[i] || a.cellY[i] != b.cellY[i] || a.isVert[i] != b.isVert[i];
+                check(mismatches == 0, "packets at " + std::to_string(rotation) + " degrees in layout " + std::to_string(int(layout)) +
+                                       ", acceleration " + std::to_string(int(mode)) + ", projection " + std::to_string(int(projection)) +
+                                       " match scalar");
+            }
+        }
+    }
+}
+
+
+// text maps parse into the same ids, a written map file maps back to them, and
+// a world given the mapped tiles reads them in place and casts alike
+void testMapFile()
+{
+    std::vector<int> ids;
+    unsigned cols = 0, rows = 0;
+    const std::string literal = "std::vector<int> levelMap {\n    1,1,1,1, // top\n    1,0,-2,1,\n    1,1,1,1,\n};\n";
+    check(rcc::readMapText(literal, ids, cols, rows) && cols == 4 && rows == 3 && ids[6] == -2, "parse a levelMap literal");
+    cols = 0;
+    check(!rcc::readMapText("1,1,1\n1,0\n1,1,1\n", ids, cols, rows), "reject a ragged csv");
+    cols = 2;
+    check(rcc::readMapText("1,1,1,0,1,1\n", ids, cols, rows) && rows == 3, "csv on one line with the width given");
+    cols = 3;
+    check(!rcc::readMapText("1,1\n1,1,1,1\n", ids, cols, rows), "reject ragged rows that add up to the width given");
+
+    const int n = 77;
+    auto map = makeMap(n, 0.05f, 13);
+    const std::string path = (std::filesystem::temp_directory_path() / "rcc_test_map.rccm").string();
+    check(rcc::writeMapFile(path.c_str(), map, n, n), "write a map file");
+
+    rcc::MapFile file;
+    if(!file.open(path.c_str())) {
+        check(false, "open a map file: " + file.getError());
+        return;
+    }
+    check(file.getCols() == unsigned(n) && file.getRows() == unsigned(n) &&
+          std::equal(map.begin(), map.end(), file.getIds()), "ids read back from a map file");
+
+    auto fromVector = rcc::createWorld(64, rcc::Vector{ 640, 480 });
+    fromVector->setWorldInfo(map, n, n);
+    auto fromFile = rcc::createWorld(64, rcc::Vector{ 640, 480 });
+    file.applyTo(*fromFile);
+    check(fromFile->getOccupancy() == file.getOccupancy(), "mapped occupancy is used in place");
+
+    rcc::RayCastable a(360.0f, 0.0f, 720);
+    a.pos = rcc::Vector{ 38.5f * 64, 38.5f * 64 };
+    rcc::RayCastable b = a;
+    a.castRay(*fromVector);
+    b.castRay(*fromFile);
+    for(size_t i = 0; i < a.getRayBuffer().size(); i++)
+        check(a.getRayBuffer().tileId[i] == b.getRayBuffer().tileId[i] && a.getRayBuffer().dist[i] == b.getRayBuffer().dist[i],
+              "ray " + std::to_string(i) + " on a mapped map");
+
+    file.close();
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    auto openModified = [&](std::vector<char> modified) {
+        std::ofstream(path, std::ios::binary).write(modified.data(), modified.size());
+        return file.open(path.c_str());
+    };
+    std::vector<char> badMagic = bytes;
+    badMagic[0] = 'X';
+    check(!openModified(badMagic), "reject a file without the magic");
+    check(!openModified(std::vector<char>(bytes.begin(), bytes.begin() + bytes.size() / 2)), "reject a truncated map file");
+    std::remove(path.c_str());
+}
+
+
+// a streamed map with every chunk resident casts like the whole map, a chunk
+// that is not resident stops rays without blocking, and the budget evicts the
+// least recently used chunk
+void testStreamedMap()
+{
+    const int cols = 600, rows = 520, tileSize = 64;
+    std::vector<int> map(cols * rows);
+    std::mt19937 gen(14);
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    for(auto& id: map) id = dis(gen) < 0.004f ? 1 + int(dis(gen) * 3) : 0;
+    map[270 * cols + 300] = 0;
+
+    auto whole = rcc::createWorld(tileSize, rcc::Vector{ 640, 480 });
+    whole->setWorldInfo(map, cols, rows);
+    rcc::RayCastable expected(360.0f, 0.0f, 720);
+    expected.pos = rcc::Vector{ 300.5f * tileSize, 270.5f * tileSize };
+    expected.castRay(*whole);
+
+    rcc::GeneratedChunkSource generated([&](int y, int x) { return x < cols && y < rows ? map[y * cols + x] : 0; });
+    const std::string path = (std::filesystem::temp_directory_path() / "rcc_test_stream.rccm").string();
+    rcc::writeMapFile(path.c_str(), map, cols, rows);
+    rcc::MapFileChunkSource fromFile;
+    check(fromFile.open(path.c_str()) && fromFile.getCols() == unsigned(cols), "open a map file to stream from");
+
+    for(rcc::ChunkSource* source: { static_cast<rcc::ChunkSource*>(&generated), static_cast<rcc::ChunkSource*>(&fromFile) })
+    {
+        auto world = rcc::createWorld(tileSize, rcc::Vector{ 640, 480 });
+        rcc::RayCastable player = expected;
+        world->setPlayer(player);
+        rcc::ChunkStreamer streamer(*source, cols, rows, 9, 2);
+        streamer.attach(*world);
+        streamer.flush(*world);
+        world->update(0.0f);
+        check(streamer.getResidentCount() == 9, "every chunk resident within the budget");
+
+        for(size_t i = 0; i < expected.getRayBuffer().size(); i++)
+            check(player.getRayBuffer().tileId[i] == expected.getRayBuffer().tileId[i] &&
+                  player.getRayBuffer().dist[i] == expected.getRayBuffer().dist[i],
+                  "streamed ray " + std::to_string(i));
+    }
+
+    // a truncated file is rejected when it is opened, and one cut short after
+    // it was opened fails the chunks past the end instead of streaming zeros
+    const auto fullSize = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, fullSize / 2);
+    rcc::MapFileChunkSource truncated;
+    check(!truncated.open(path.c_str()) && !truncated.getError().empty(), "reject a truncated map file");
+    {
+        auto world = rcc::createWorld(tileSize, rcc::Vector{ 640, 480 });
+        rcc::RayCastable player = expected;
+        world->setPlayer(player);
+        rcc::ChunkStreamer streamer(fromFile, cols, rows, 9, 2);
+        streamer.attach(*world);
+        streamer.flush(*world);
+        check(streamer.getFailedCount() > 0 && streamer.getResidentCount() + streamer.getFailedCount() == 9,
+              "chunks past the end of a shortened file fail to load");
+        check(!streamer.isResident(4, 4), "a chunk that failed to load is not resident");
+    }
+    std::remove(path.c_str());
+
+    // one chunk of budget: only the player's chunk is there, everything past
+    // it reads as not resident
+    auto world = rcc::createWorld(tileSize, rcc::Vector{ 640, 480 });
+    rcc::RayCastable player(360.0f, 0.0f, 720);
+    player.pos = rcc::Vector{ 100.5f * tileSize, 100.5f * tileSize };
+    world->setPlayer(player);
+    rcc::ChunkStreamer streamer(generated, cols, rows, 1, 1);
+    streamer.attach(*world);
+    streamer.flush(*world);
+    world->update(0.0f);
+    check(streamer.isResident(0, 0) && streamer.getResidentCount() == 1, "the player's chunk resident on a budget of one");
+
+    const auto& rays = player.getRayBuffer();
+    size_t unloaded = 0;
+    for(size_t i = 0; i < rays.size(); i++)
+    {
+        if(rays.tileId[i] != rcc::World::unloadedTile) continue;
+        unloaded++;
+        check(rays.cellX[i] >> rcc::MapChunk::shift != 0 || rays.cellY[i] >> rcc::MapChunk::shift != 0,
+              "ray " + std::to_string(i) + " stopped as unloaded inside a resident chunk");
+    }
+    check(unloaded > 0, "rays reach the chunks that are not resident");
+
+    player.pos = rcc::Vector{ 550.5f * tileSize, 515.5f * tileSize };
+    streamer.flush(*world);
+    check(streamer.isResident(2, 2) && !streamer.isResident(0, 0) && streamer.getResidentCount() == 1,
+          "the least recently used chunk makes room");
+}
+
+
+// culling against the depth buffer keeps exactly the sprites with a column in
+// front of the walls, trimmed to the first and last such column, far to near
+void testSpriteCulling()
+{
+    const int n = 48, tileSize = 64;
+    auto map = makeMap(n, 0.06f, 15);
+    map[24 * n + 24] = 0;
+    auto world = rcc::createWorld(tileSize, rcc::Vector{ 640, 480 });
+    world->setWorldInfo(map, n, n);
+
+    for(const rcc::Projection projection: { rcc::Projection::CameraPlane, rcc::Projection::Angular })
+    {
+        rcc::RayCastable viewer(70.0f, 30.0f, 320, projection);
+        viewer.pos = rcc::Vector{ 24.5f * tileSize, 24.5f * tileSize };
+        viewer.castRay(*world);
+        const auto& dist = viewer.getRayBuffer().dist;
+
+        rcc::DepthBuffer depth;
+        depth.build(viewer.getRayBuffer());
+        std::mt19937 gen(16);
+        std::uniform_int_distribution<int> column(0, depth.size() - 1);
+        for(int q = 0; q < 200; q++)
+        {
+            int first = column(gen), last = column(gen);
+            if(first > last) std::swap(first, last);
+            last++;
+            check(depth.farthest(first, last) == *std::max_element(dist.begin() + first, dist.begin() + last),
+                  "farthest depth over [" + std::to_string(first) + ", " + std::to_string(last) + ")");
+        }
+
+        std::uniform_real_distribution<float> spot(1.0f * tileSize, (n - 1.0f) * tileSize);
+        std::vector<rcc::Sprite> sprites(500);
+        for(auto& sprite: sprites) sprite = { rcc::Vector{ spot(gen), spot(gen) }, 40.0f };
+
+        std::vector<rcc::SpriteSpan> visible;
+        rcc::cullSprites(viewer, depth, sprites, visible);
+
+        std::vector<int> kept(sprites.size(), -1);
+        for(size_t v = 0; v < visible.size(); v++) {
+            kept[visible[v].sprite] = int(v);
+            if(v > 0) check(visible[v - 1].depth >= visible[v].depth, "sprites sorted far to near");
+        }
+
+        const rcc::Vector right = rcc::Vector::fromAngle(rcc::degToRad(viewer.rotation + 90.0f)) * 20.0f;
+        for(size_t i = 0; i < sprites.size(); i++)
+        {
+            float d = 0.0f, unused = 0.0f;
+            viewer.projectToColumn(sprites[i].pos, d);
+            int first = -1, last = -1;
+            if(d >= 1.0f) {
+                const int x0 = std::max(int(std::ceil(viewer.projectToColumn(sprites[i].pos - right, unused))), 0);
+                const int x1 = std::min(int(std::ceil(viewer.projectToColumn(sprites[i].pos + right, unused))), depth.size());
+                for(int x = x0; x < x1; x++)
+                    if(dist[x] > d) {
+                        if(first < 0) first = x;
+                        last = x + 1;
+                    }
+            }
+
+            const std::string what = "sprite " + std::to_string(i);
+            if(first < 0) {
+                check(kept[i] < 0, what + " is hidden but was kept");
+                continue;
+            }
+            check(kept[i] >= 0 && visible[kept[i]].first == first && visible[kept[i]].last == last, what + " span");
+        }
+    }
+}
+
+
+// patching the pyramid for one tile has to give what a full rebuild gives
+void testPyramidTileUpdate()
+{
+    const int n = 100;
+    auto map = makeMap(n, 0.01f, 3);
+    auto patched = rcc::createWorld(64, rcc::Vector{ 640, 480 });
+    patched->setWorldInfo(map, n, n);
+    patched->setAcceleration(rcc::Acceleration::Pyramid);
+
+    std::mt19937 gen(4);
+    std::uniform_int_distribution<int> cell(0, n - 1);
+    for(int edit = 0; edit < 50; edit++)
+    {
+        const int y = cell(gen), x = cell(gen);
+        map[y * n + x] = edit % 3 == 0 ? 1 : 0;
+        patched->markTileChanged(y, x);
+    }
+
+    auto rebuilt = rcc::createWorld(64, rcc::Vector{ 640, 480 });
+    rebuilt->setWorldInfo(map, n, n);
+    rebuilt->setAcceleration(rcc::Acceleration::Pyramid);
+    for(int y = 0; y < n; y++)
+        for(int x = 0; x < n; x++)
+            check(patched->getEmptyLevel(y, x) == rebuilt->getEmptyLevel(y, x),
+                  "empty level of (" + std::to_string(x) + ", " + std::to_string(y) + ") after tile edits");
+}
+
+
+int main()
+{
+    testFixedPointWithinOneTile();
+    testUpdateSkipsUnchangedCastables();
+    testTurnReusesColumns();
+    testAccelerationMatchesCellWalk();
+    testDistanceField();
+    testPyramidTileUpdate();
+    testOccupancyBitmap();
+    testLayoutsCastAlike();
+    testPacketsMatchScalar();
+    testMapFile();
+    testStreamedMap();
+    testSpriteCulling();
+
+    if(failures) std::cerr << failures << " check(s) failed" << std::endl;
+    else std::cout << "all checks passed" << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file rcc_mapconv.cpp
+ * @date 16-oct-2026
+ * Convert a text map, CSV or a levelMap style C++ initializer list, into an
+ * rcc map file that rcc::MapFile can map.
+ *
+ * Usage: rcc_mapconv input output [--cols N]
+ * --cols is only needed when the rows are not on lines of their own
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+#include "../include/rcc_map.h"
+
+
+int main(int argc, char const *argv[])
+{
+    if(argc != 3 && !(argc == 5 && std::strcmp(argv[3], "--cols") == 0)) {
+        std::cerr << "Usage: " << argv[0] << " input output [--cols N]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1]);
+    if(!input) {
+        std::cerr << "Unable to read " << argv[1] << std::endl;
+        return 1;
+    }
+    std::stringstream text;
+    text << input.rdbuf();
+
+    std::vector<int> ids;
+    unsigned cols = argc == 5 ? std::max(0, std::atoi(argv[4])) : 0, rows = 0;
+    if(!rcc::readMapText(text.str(), ids, cols, rows)) {
+        std::cerr << "No rectangular map in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    if(!rcc::writeMapFile(argv[2], ids, cols, rows)) {
+        std::cerr << "Unable to write " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << cols << "x" << rows << " map to " << argv[2] << std::endl;
+    return 0;
+}
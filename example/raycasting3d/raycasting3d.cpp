@@ -8,6 +8,10 @@
 #include <vector>
 #include <cmath>
 #include <SDL.h>
+#include <dl2hub/circle.h>
+#include <dl2hub/fixed_timestep.h>
+#include <dl2hub/framebuffer.h>
+#include <dl2hub/profiler.h>
 #ifdef EMSCRIPTEN
     #include <emscripten/emscripten.h>
 #endif
@@ -19,8 +23,9 @@ template<typename T>
 T getMapId(const Map_t& map, const T& y, const T& x);
 
 float degToRad(float f);
+void update(float dt);
 
-void drawFilledCircle(SDL_Renderer* renderer, const float& x, const float& y, const float& radius);
+dl2hub::CircleCache circles;
 
 float maxDist = -INFINITY;
 const short TILESIZE = 64;
@@ -28,6 +33,7 @@ const short TILE_COL = 8;
 const short TILE_ROW = 8;
 bool shouldQuit = false;
 SDL_Event evt;
+dl2hub::FixedTimestep timestep;
 
 
 struct 
@@ -39,6 +45,9 @@ struct
 } canvas;
 
 
+dl2hub::Framebuffer frame;
+
+
 struct Vec2
 {
     float x;
@@ -94,12 +103,19 @@ void init()
     for(float angle = -fovHalf; angle < fovHalf; angle += rayInc)
         player.rays.push_back(Ray{ angle });
     
+    if(!frame.create(canvas.renderer, canvas.w, canvas.h))
+        std::cerr << "Unable to create framebuffer: " << SDL_GetError() << std::endl;
+
+    // the first advance() of the timestep runs no update, cast once so the
+    // first frame has rays to draw
+    update(0.0f);
 }
 
 
 
 void update(float dt)
 {
+    DL2HUB_PROFILE_SCOPE("update");
     for(auto it = player.rays.begin(); it != player.rays.end(); it++) 
     {
         float angleInRadians = degToRad(player.rotation + it->angle);
@@ -183,57 +199,56 @@ void update(float dt)
 
 void render(SDL_Renderer* renderer) 
 {
+    DL2HUB_PROFILE_SCOPE("render");
+    // everything but the player marker goes into the framebuffer, which is
+    // then drawn with a single copy
+    if(!frame.lock()) return;
+    frame.clear(dl2hub::Framebuffer::color(0x00, 0x00, 0x00));
 
     // render tile
+    const Uint32 floorColor = dl2hub::Framebuffer::color(0xff, 0xff, 0xff);
+    const Uint32 wallColor = dl2hub::Framebuffer::color(0xff, 0x00, 0x00);
+    const Uint32 outlineColor = dl2hub::Framebuffer::color(0x00, 0x00, 0x00);
     for(short i = 0; i < TILE_ROW; i++) {
         for(short j = 0; j < TILE_COL; j++) {
             short id = getMapId<short>(levelMap, i, j);
-            float px = j * TILESIZE;
-            float py = i * TILESIZE;
-            SDL_FRect rect { px, py, (float)TILESIZE, (float)TILESIZE };
-
-            if(id == 0) {
-                SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
-                SDL_RenderFillRectF(renderer, &rect);
-                SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
-                SDL_RenderDrawRectF(renderer, &rect);
-            } else {
-                SDL_SetRenderDrawColor(renderer, 0xff, 0x00, 0x00, 0xff);
-                SDL_RenderFillRectF(renderer, &rect);
-                SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
-                SDL_RenderDrawRectF(renderer, &rect);
-            }
+            SDL_Rect rect { j * TILESIZE, i * TILESIZE, TILESIZE, TILESIZE };
+            frame.fillRect(rect, id == 0 ? floorColor : wallColor);
+            frame.drawRect(rect, outlineColor);
         }
     }
 
     auto pOffset = 512;
 
+    const Uint32 leftColor = dl2hub::Framebuffer::color(0x00, 0xff, 0x00);
+    const Uint32 rightColor = dl2hub::Framebuffer::color(0x00, 0x33, 0x00);
+    const Uint32 rayColor = dl2hub::Framebuffer::color(0x68, 0xf2, 0x52);
     int x = 0;
     for(const auto& r: player.rays) {
-        float px = pOffset + x;
         float h = std::min((r.dist - 277.0f) / 277.0f * 64, canvas.h * 0.5f);
         float py = canvas.h * 0.5 * 0.5 - h * 0.5;
 
-        if(r.isLeft) SDL_SetRenderDrawColor(renderer, 0x00, 0xff, 0x00, 0xff);
-        else SDL_SetRenderDrawColor(renderer, 0x00, 0x33, 0x00, 0xff);
-        SDL_RenderDrawLineF(renderer, px, py, px, py + h);
+        frame.drawColumn(pOffset + x, py, py + h, r.isLeft ? leftColor : rightColor);
         x++;
 
-        SDL_SetRenderDrawColor(renderer, 0x68, 0xf2, 0x52, 0xff);
-        SDL_RenderDrawLineF(renderer, r.start.x, r.start.y, r.end.x, r.end.y);
+        frame.drawLine(r.start.x, r.start.y, r.end.x, r.end.y, rayColor);
     }
 
-    SDL_SetRenderDrawColor(renderer, 0x32, 0x54, 0xa4, 0xff);
-    SDL_RenderDrawLineF(renderer, pOffset, canvas.h/2, canvas.w, canvas.h/2);
+    const Uint32 horizonColor = dl2hub::Framebuffer::color(0x32, 0x54, 0xa4);
+    frame.fillRect({ pOffset, int(canvas.h / 2), int(canvas.w) - pOffset, 1 }, horizonColor);
+
+    frame.present(renderer);
     
     SDL_SetRenderDrawColor(renderer, 0x32, 0x54, 0xa4, 0xff);
-    drawFilledCircle(renderer, player.pos.x, player.pos.y, 4);
+    circles.draw(renderer, player.pos.x, player.pos.y, 4);
 
 }
 
 
 void processEvent(SDL_Event& evt, bool& shouldQuit)
 {
+    DL2HUB_PROFILE_SCOPE("events");
+    if(dl2hub::Profiler::get().handleEvent(evt)) return;
     if(evt.type == SDL_QUIT) {
         shouldQuit = true;
         return;
@@ -272,12 +287,17 @@ void gameLoop()
 {
         while (SDL_PollEvent(&evt))
             processEvent(evt, shouldQuit);
+        timestep.advance(update);
         
         SDL_SetRenderDrawColor(canvas.renderer, 0x00, 0x00, 0x00, 0x00);
         SDL_RenderClear(canvas.renderer);
         render(canvas.renderer);
-        update(1/60);
-        SDL_RenderPresent(canvas.renderer);
+        dl2hub::Profiler::get().drawHud(canvas.renderer);
+        {
+            DL2HUB_PROFILE_SCOPE("present");
+            SDL_RenderPresent(canvas.renderer);
+        }
+        dl2hub::Profiler::get().endFrame();
 }
 
 
@@ -321,6 +341,7 @@ int main(int argc, char const *argv[])
     init();
     mainLoop();
 
+    circles.clear();
     SDL_DestroyWindow(canvas.window);
     SDL_Quit();
 
@@ -331,45 +352,10 @@ int main(int argc, char const *argv[])
 template<typename T>
 T getMapId(const Map_t &map, const T&y, const T&x)
 {
-    T res;
-    T index = y * TILE_COL + x;
-    if(index >= map.size()) return -1;
-    try {
-        res = map.at(index);
-    } catch(...) {
-        res = -1;
-    }
-    return res;
-}
-
-
-void drawFilledCircle(SDL_Renderer* renderer, const float& px, const float& py, const float& radius)
-{
-    auto drawHorizontalLine = [](SDL_Renderer* renderer, int x1, int x2, int y) -> void {
-        for(int x = x1; x <= x2; x++)
-            SDL_RenderDrawPoint(renderer, x, y);
-    };
-
-    int x = 0;
-    int y = radius;
-    int d = 3 - (int(radius) << 1);
-
-    while (y >= x)
-    {
-        drawHorizontalLine(renderer, px - x, px + x, py - y);
-        drawHorizontalLine(renderer, px - x, px + x, py + y);
-        drawHorizontalLine(renderer, px - y, px + y, py - x);
-        drawHorizontalLine(renderer, px - y, px + y, py + x);
-
-        if(d < 0) 
-            d = d + (x << 2) + 6;
-        else {
-            d = d + ((x - y) << 2) + 10;
-            y--;
-        }
-        x++;
-    }
-    
+    if(static_cast<unsigned>(x) >= static_cast<unsigned>(TILE_COL) ||
+       static_cast<unsigned>(y) >= static_cast<unsigned>(TILE_ROW))
+        return -1;
+    return map[y * TILE_COL + x];
 }
 
 
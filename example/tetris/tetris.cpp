@@ -10,6 +10,7 @@
 #include <random>
 #include <cassert>
 #include <SDL.h>
+#include <dl2hub/profiler.h>
 
 #ifdef EMSCRIPTEN
     #include <emscripten/emscripten.h>
@@ -125,6 +126,7 @@ void init()
 
 void update(float dt)
 {
+    DL2HUB_PROFILE_SCOPE("update");
     elapsedTime += dt;
     pCurrentTetromino = currentTetromino.size() ? &currentTetromino.back() : nullptr;
     
@@ -154,6 +156,7 @@ void update(float dt)
 
 
 void render(SDL_Renderer* renderer){
+    DL2HUB_PROFILE_SCOPE("render");
     SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
     SDL_RenderClear(renderer);
 
@@ -178,6 +181,8 @@ void render(SDL_Renderer* renderer){
 
 void processEvent(SDL_Event& evt)
 {
+    DL2HUB_PROFILE_SCOPE("events");
+    if(dl2hub::Profiler::get().handleEvent(evt)) return;
     if(evt.type == SDL_QUIT) {
         canvas.isOpen = false;
         return;
@@ -243,7 +248,12 @@ void loop()
     update(dt);
     while (SDL_PollEvent(&canvas.evt))
         processEvent(canvas.evt);
-    SDL_RenderPresent(canvas.renderer);
+    dl2hub::Profiler::get().drawHud(canvas.renderer);
+    {
+        DL2HUB_PROFILE_SCOPE("present");
+        SDL_RenderPresent(canvas.renderer);
+    }
+    dl2hub::Profiler::get().endFrame();
 }
 
 
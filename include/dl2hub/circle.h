@@ -0,0 +1,183 @@
+/**
+ * @file circle.h
+ * @date 16-oct-2026
+ * Filled circles for the examples. A circle is rasterized once per radius
+ * into one span per row, so no pixel is covered twice, and the spans are
+ * baked into a white texture that is tinted with the draw colour. Drawing
+ * a circle is then a single copy, where the per pixel loops it replaces
+ * made one renderer call per pixel, most pixels several times over
+ */
+#ifndef __BYTENOL_DL2HUB_CIRCLE_H__
+#define __BYTENOL_DL2HUB_CIRCLE_H__
+
+#include <cmath>
+#include <vector>
+
+// the examples built against SDL3 share the header
+#if __has_include(<SDL.h>)
+    #include <SDL.h>
+#else
+    #include <SDL3/SDL.h>
+#endif
+
+
+namespace dl2hub
+{
+
+    /// One row of a circle, relative to its centre
+    struct CircleSpan
+    {
+        int y;
+        int x0;     // first pixel
+        int x1;     // last pixel, inclusive
+    };
+
+    /// @brief Split a filled circle into one span per row, top to bottom
+    /// @param radius is the radius in pixels, rounded down like the old
+    /// midpoint loops did
+    /// @param spans receives the spans, cleared first
+    void getCircleSpans(float radius, std::vector<CircleSpan>& spans);
+
+    /// @brief Fill a circle with the current draw colour in one SDL_RenderFillRects
+    /// call, for renderers that cannot make textures
+    void fillCircleSpans(SDL_Renderer* renderer, float px, float py, float radius);
+
+
+    /// Circle textures of one renderer, by radius. The caller owns their
+    /// lifetime: call clear() before the renderer is destroyed. Drawing with
+    /// another renderer destroys the textures of the previous one, so it has
+    /// to be alive then too
+    class CircleCache
+    {
+        public:
+            static constexpr int maxCachedRadius = 256;     // larger circles are drawn as spans
+
+            CircleCache() = default;
+
+            CircleCache(const CircleCache&) = delete;
+            CircleCache& operator=(const CircleCache&) = delete;
+
+            /// @brief Fill a circle with the current draw colour, one draw call
+            /// @param renderer is the renderer to draw with
+            /// @param px is the x position of the centre
+            /// @param py is the y position of the centre
+            /// @param radius is the radius in pixels
+            void draw(SDL_Renderer* renderer, float px, float py, float radius);
+
+            /// @brief Destroy every cached texture, the renderer must still exist
+            void clear();
+
+        private:
+            SDL_Texture* getTexture(int radius);
+
+            SDL_Renderer* renderer = nullptr;
+            std::vector<SDL_Texture*> textures;     // by radius, nullptr until first drawn
+            bool noTextures = false;                // the renderer failed to make one, use spans
+            std::vector<CircleSpan> spans;
+    };
+
+
+    inline void getCircleSpans(float radius, std::vector<CircleSpan> &spans)
+    {
+        spans.clear();
+        const int r = int(radius);
+        if(r < 0) return;
+        for(int y = -r; y <= r; y++)
+        {
+            const int half = int(std::sqrt(float(r * r - y * y)) + 0.5f);
+            spans.push_back({ y, -half, half });
+        }
+    }
+
+    inline void fillCircleSpans(SDL_Renderer *renderer, float px, float py, float radius)
+    {
+        thread_local std::vector<CircleSpan> spans;
+        getCircleSpans(radius, spans);
+
+        const int cx = int(px), cy = int(py);
+    #if SDL_MAJOR_VERSION >= 3
+        thread_local std::vector<SDL_FRect> rects;
+        rects.clear();
+        for(const CircleSpan& s: spans)
+            rects.push_back({ float(cx + s.x0), float(cy + s.y), float(s.x1 - s.x0 + 1), 1.0f });
+    #else
+        thread_local std::vector<SDL_Rect> rects;
+        rects.clear();
+        for(const CircleSpan& s: spans)
+            rects.push_back({ cx + s.x0, cy + s.y, s.x1 - s.x0 + 1, 1 });
+    #endif
+        SDL_RenderFillRects(renderer, rects.data(), int(rects.size()));
+    }
+
+
+    inline void CircleCache::draw(SDL_Renderer *renderer, float px, float py, float radius)
+    {
+        const int r = int(radius);
+        if(r < 0) return;
+        if(renderer != this->renderer) {
+            clear();
+            this->renderer = renderer;
+        }
+
+        SDL_Texture* texture = r <= maxCachedRadius ? getTexture(r) : nullptr;
+        if(!texture) {
+            fillCircleSpans(renderer, px, py, radius);
+            return;
+        }
+
+        Uint8 red, green, blue, alpha;
+        SDL_GetRenderDrawColor(renderer, &red, &green, &blue, &alpha);
+        SDL_SetTextureColorMod(texture, red, green, blue);
+        SDL_SetTextureAlphaMod(texture, alpha);
+
+        // truncated like the spans, so both paths put the pixels in the same place
+        const int size = 2 * r + 1;
+    #if SDL_MAJOR_VERSION >= 3
+        const SDL_FRect dst{ float(int(px) - r), float(int(py) - r), float(size), float(size) };
+        SDL_RenderTexture(renderer, texture, nullptr, &dst);
+    #else
+        const SDL_Rect dst{ int(px) - r, int(py) - r, size, size };
+        SDL_RenderCopy(renderer, texture, nullptr, &dst);
+    #endif
+    }
+
+    inline void CircleCache::clear()
+    {
+        for(SDL_Texture* texture: textures)
+            if(texture) SDL_DestroyTexture(texture);
+        textures.clear();
+        renderer = nullptr;
+        noTextures = false;
+    }
+
+    inline SDL_Texture *CircleCache::getTexture(int radius)
+    {
+        if(size_t(radius) < textures.size() && textures[radius]) return textures[radius];
+        if(noTextures) return nullptr;
+
+        // a renderer that cannot make one texture is not asked again every circle
+        const int size = 2 * radius + 1;
+        SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, size, size);
+        if(!texture) {
+            noTextures = true;
+            return nullptr;
+        }
+
+        // white where the spans cover, clear everywhere else
+        std::vector<Uint32> pixels(size_t(size) * size, 0x00ffffffu);
+        getCircleSpans(float(radius), spans);
+        for(const CircleSpan& s: spans)
+            for(int x = s.x0; x <= s.x1; x++)
+                pixels[size_t(s.y + radius) * size + (x + radius)] = 0xffffffffu;
+        SDL_UpdateTexture(texture, nullptr, pixels.data(), size * int(sizeof(Uint32)));
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+        if(textures.size() <= size_t(radius)) textures.resize(radius + 1, nullptr);
+        textures[radius] = texture;
+        return texture;
+    }
+
+}
+
+
+#endif
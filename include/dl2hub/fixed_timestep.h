@@ -0,0 +1,129 @@
+/**
+ * @file fixed_timestep.h
+ * @date 16-oct-2026
+ * A fixed timestep driver for the example loops. Real time measured with
+ * SDL_GetPerformanceCounter goes into an accumulator and the simulation
+ * runs in whole steps of dt, however often frames are drawn. What is left
+ * in the accumulator tells the renderer how far it is between the last two
+ * simulation states, see interpolate()
+ */
+#ifndef __BYTENOL_DL2HUB_FIXED_TIMESTEP_H__
+#define __BYTENOL_DL2HUB_FIXED_TIMESTEP_H__
+
+#include <algorithm>
+
+// the examples built against SDL3 share the header
+#if __has_include(<SDL.h>)
+    #include <SDL.h>
+#else
+    #include <SDL3/SDL.h>
+#endif
+
+
+namespace dl2hub
+{
+
+    class FixedTimestep
+    {
+        public:
+            /// @param dt is the simulated time of one update, in seconds
+            /// @param maxFrameTime caps the real time a single frame adds. After a
+            /// stall, a breakpoint or a dragged window, the simulation slows down
+            /// instead of running hundreds of updates to catch up
+            explicit FixedTimestep(float dt = 1.0f / 60.0f, float maxFrameTime = 0.25f);
+
+            /// @brief Add the real time since the last call and run every whole
+            /// step that fits. The first call only starts the clock
+            /// @param update is called as update(getDt()) once per step
+            /// @return the number of steps run
+            template<typename Fn>
+            int advance(Fn&& update);
+
+            /// @brief advance() with the elapsed time given instead of measured
+            /// @param seconds is the real time that passed
+            /// @param update is called as update(getDt()) once per step
+            /// @return the number of steps run
+            template<typename Fn>
+            int advanceBy(double seconds, Fn&& update);
+
+            /// @brief Get how far the time being rendered is from the previous
+            /// simulation state towards the current one, in [0, 1)
+            float getAlpha() const;
+
+            float getDt() const;
+
+            /// @brief Forget the time measured so far, e.g. after loading a level,
+            /// so it is not simulated on the next advance()
+            void reset();
+
+        private:
+            double dt;
+            double maxFrameTime;
+            double accumulator = 0.0;
+            Uint64 last = 0;
+            bool started = false;
+    };
+
+
+    /// @brief Blend two simulation states for rendering
+    /// @param previous is the state before the last update
+    /// @param current is the state after the last update
+    /// @param alpha is FixedTimestep::getAlpha()
+    template<typename T>
+    T interpolate(T previous, T current, float alpha);
+
+
+    inline FixedTimestep::FixedTimestep(float dt, float maxFrameTime)
+    {
+        this->dt = dt;
+        this->maxFrameTime = std::max(maxFrameTime, dt);
+    }
+
+    template<typename Fn>
+    inline int FixedTimestep::advance(Fn &&update)
+    {
+        const Uint64 now = SDL_GetPerformanceCounter();
+        double seconds = 0.0;
+        if(started) seconds = double(now - last) / double(SDL_GetPerformanceFrequency());
+        last = now;
+        started = true;
+        return advanceBy(seconds, update);
+    }
+
+    template<typename Fn>
+    inline int FixedTimestep::advanceBy(double seconds, Fn &&update)
+    {
+        accumulator += std::clamp(seconds, 0.0, maxFrameTime);
+
+        int steps = 0;
+        for(; accumulator >= dt; accumulator -= dt, steps++)
+            update(float(dt));
+        return steps;
+    }
+
+    inline float FixedTimestep::getAlpha() const
+    {
+        return float(accumulator / dt);
+    }
+
+    inline float FixedTimestep::getDt() const
+    {
+        return float(dt);
+    }
+
+    inline void FixedTimestep::reset()
+    {
+        accumulator = 0.0;
+        started = false;
+    }
+
+    template<typename T>
+    inline T interpolate(T previous, T current, float alpha)
+    {
+        return previous + (current - previous) * alpha;
+    }
+
+}
+
+
+#endif
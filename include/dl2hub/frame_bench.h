@@ -0,0 +1,279 @@
+/**
+ * @file frame_bench.h
+ * @date 16-oct-2026
+ * Headless frame timing for the examples. A FrameBench opens a window on
+ * SDL's dummy video driver with the software renderer, feeds scripted key
+ * presses through the normal event queue and times every stage of every
+ * frame. The report is min/median/p99 per stage and per frame, as JSON.
+ *
+ * Command line: --frames N, --warmup N (frames left out of the report)
+ * and --out path (defaults to stdout). SDL_VIDEODRIVER still overrides
+ * the dummy driver, e.g. to watch a run in a real window
+ */
+#ifndef __BYTENOL_DL2HUB_FRAME_BENCH_H__
+#define __BYTENOL_DL2HUB_FRAME_BENCH_H__
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <SDL.h>
+
+
+namespace dl2hub
+{
+
+    class FrameBench
+    {
+        public:
+            /// @param name is the name of the example, written into the report
+            /// @param argc is the argument count of main
+            /// @param argv is the arguments of main
+            FrameBench(const char* name, int argc, char const *argv[]);
+            ~FrameBench();
+
+            FrameBench(const FrameBench&) = delete;
+            FrameBench& operator=(const FrameBench&) = delete;
+
+            /// @brief Initialize SDL headless and create the window and renderer
+            /// @param w is the width of the window
+            /// @param h is the height of the window
+            /// @return false if SDL could not be set up, the error is printed
+            bool open(int w, int h);
+
+            SDL_Window* getWindow() const;
+
+            SDL_Renderer* getRenderer() const;
+
+            /// @brief Get the fixed time step every frame is simulated with
+            float getDt() const;
+
+            /// @brief Press a key at the start of a frame
+            /// @param frame is the frame the key goes down on
+            /// @param key is the key to press
+            /// @param holdFrames is how many frames later the key is released
+            void press(int frame, SDL_Keycode key, int holdFrames = 1);
+
+            /// @brief Time fn as a stage of the current frame. init code can be
+            /// timed too, before the first nextFrame()
+            template<typename Fn>
+            void stage(const char* name, Fn&& fn);
+
+            /// @brief Finish the current frame and start the next one, posting the
+            /// key presses scheduled for it
+            /// @return false once every frame has run
+            bool nextFrame();
+
+            /// @brief Write the JSON report
+            /// @return the exit code for main
+            int report();
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            struct Samples
+            {
+                std::string name;
+                std::vector<double> ms;
+            };
+
+            struct ScriptedKey
+            {
+                int frame;
+                SDL_EventType type;
+                SDL_Keycode key;
+            };
+
+            Samples& getSamples(const char* name);
+            bool isMeasured() const;
+            static void writeStats(std::ostream& os, std::vector<double> ms);
+
+            std::string name;
+            int frames = 600;
+            int warmup = 30;
+            float dt = 1.0f / 60.0f;
+            std::string outPath;
+
+            SDL_Window* window = nullptr;
+            SDL_Renderer* renderer = nullptr;
+
+            int frame = -1;
+            Clock::time_point frameStart;
+            std::vector<Samples> stages;    // in the order they first ran
+            Samples frameTimes;
+            std::vector<ScriptedKey> script;
+    };
+
+
+    inline FrameBench::FrameBench(const char *name, int argc, char const *argv[])
+    {
+        this->name = name;
+        for(int i = 1; i + 1 < argc; i += 2)
+        {
+            if(std::strcmp(argv[i], "--frames") == 0) frames = std::max(1, std::atoi(argv[i + 1]));
+            else if(std::strcmp(argv[i], "--warmup") == 0) warmup = std::max(0, std::atoi(argv[i + 1]));
+            else if(std::strcmp(argv[i], "--out") == 0) outPath = argv[i + 1];
+            else std::cerr << "Ignoring unknown option " << argv[i] << std::endl;
+        }
+        frameTimes.name = "frame";
+    }
+
+    inline FrameBench::~FrameBench()
+    {
+        if(renderer) SDL_DestroyRenderer(renderer);
+        if(window) SDL_DestroyWindow(window);
+        SDL_Quit();
+    }
+
+    inline bool FrameBench::open(int w, int h)
+    {
+        // hints set at normal priority, so the environment still wins
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+
+        if(SDL_Init(SDL_INIT_VIDEO) != 0) {
+            std::cerr << "Unable to initialize SDL: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        window = SDL_CreateWindow(name.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, w, h, 0);
+        if(!window) {
+            std::cerr << "Unable to create window: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+        if(!renderer) {
+            std::cerr << "Unable to create renderer: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    inline SDL_Window *FrameBench::getWindow() const
+    {
+        return window;
+    }
+
+    inline SDL_Renderer *FrameBench::getRenderer() const
+    {
+        return renderer;
+    }
+
+    inline float FrameBench::getDt() const
+    {
+        return dt;
+    }
+
+    inline void FrameBench::press(int frame, SDL_Keycode key, int holdFrames)
+    {
+        script.push_back({ frame, SDL_KEYDOWN, key });
+        script.push_back({ frame + std::max(1, holdFrames), SDL_KEYUP, key });
+    }
+
+    template<typename Fn>
+    inline void FrameBench::stage(const char *name, Fn &&fn)
+    {
+        const auto t0 = Clock::now();
+        fn();
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+        // init stages run before the first frame and are always kept
+        if(frame < 0 || isMeasured())
+            getSamples(name).ms.push_back(ms);
+    }
+
+    inline bool FrameBench::nextFrame()
+    {
+        const auto now = Clock::now();
+        if(frame >= 0 && isMeasured())
+            frameTimes.ms.push_back(std::chrono::duration<double, std::milli>(now - frameStart).count());
+
+        if(++frame >= frames) return false;
+
+        // keys go through the event queue, so each example's own event
+        // handling is part of what gets measured
+        for(const auto& key: script)
+        {
+            if(key.frame != frame) continue;
+            SDL_Event evt{};
+            evt.type = key.type;
+            evt.key.state = key.type == SDL_KEYDOWN ? SDL_PRESSED : SDL_RELEASED;
+            evt.key.keysym.sym = key.key;
+            evt.key.keysym.scancode = SDL_GetScancodeFromKey(key.key);
+            evt.key.windowID = SDL_GetWindowID(window);
+            SDL_PushEvent(&evt);
+        }
+
+        frameStart = Clock::now();
+        return true;
+    }
+
+    inline int FrameBench::report()
+    {
+        std::ofstream file;
+        if(!outPath.empty()) {
+            file.open(outPath);
+            if(!file) {
+                std::cerr << "Unable to write " << outPath << std::endl;
+                return 1;
+            }
+        }
+        std::ostream& os = outPath.empty() ? std::cout : file;
+
+        os << "{\n";
+        os << "  \"example\": \"" << name << "\",\n";
+        os << "  \"video_driver\": \"" << (SDL_GetCurrentVideoDriver() ? SDL_GetCurrentVideoDriver() : "none") << "\",\n";
+        os << "  \"frames\": " << frames << ",\n";
+        os << "  \"warmup\": " << warmup << ",\n";
+        os << "  \"dt\": " << dt << ",\n";
+        os << "  \"stages\": {";
+        for(size_t i = 0; i < stages.size(); i++) {
+            os << (i ? ",\n" : "\n") << "    \"" << stages[i].name << "\": ";
+            writeStats(os, stages[i].ms);
+        }
+        os << "\n  },\n";
+        os << "  \"frame\": ";
+        writeStats(os, frameTimes.ms);
+        os << "\n}" << std::endl;
+        return 0;
+    }
+
+    inline FrameBench::Samples &FrameBench::getSamples(const char *name)
+    {
+        for(auto& s: stages)
+            if(s.name == name) return s;
+        stages.push_back({ name, {} });
+        return stages.back();
+    }
+
+    inline bool FrameBench::isMeasured() const
+    {
+        // with fewer frames than the warmup there would be nothing to report
+        return frame >= std::min(warmup, frames - 1);
+    }
+
+    inline void FrameBench::writeStats(std::ostream &os, std::vector<double> ms)
+    {
+        if(ms.empty()) {
+            os << "{ \"count\": 0 }";
+            return;
+        }
+
+        // nearest rank percentiles
+        std::sort(ms.begin(), ms.end());
+        auto rank = [&](double p) { return ms[std::min(ms.size() - 1, size_t(p * ms.size()))]; };
+        os << "{ \"count\": " << ms.size()
+           << ", \"min_ms\": " << ms.front()
+           << ", \"median_ms\": " << rank(0.5)
+           << ", \"p99_ms\": " << rank(0.99) << " }";
+    }
+
+}
+
+
+#endif
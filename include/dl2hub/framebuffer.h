@@ -0,0 +1,280 @@
+/**
+ * @file framebuffer.h
+ * @date 16-oct-2026
+ * A cpu side ARGB8888 pixel buffer backed by a streaming SDL_Texture.
+ * Everything drawn between lock() and present() is plain pixel writes,
+ * and present() puts the whole frame on screen with a single
+ * SDL_RenderCopy instead of one renderer call per line or rect
+ */
+#ifndef __BYTENOL_DL2HUB_FRAMEBUFFER_H__
+#define __BYTENOL_DL2HUB_FRAMEBUFFER_H__
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <SDL.h>
+
+
+namespace dl2hub
+{
+
+    class Framebuffer
+    {
+        public:
+            Framebuffer() = default;
+            ~Framebuffer();
+
+            Framebuffer(const Framebuffer&) = delete;
+            Framebuffer& operator=(const Framebuffer&) = delete;
+
+            /// @brief Create the streaming texture, replacing any previous one
+            /// @param renderer is the renderer the frame is presented with
+            /// @param w is the width of the buffer in pixels
+            /// @param h is the height of the buffer in pixels
+            /// @return false if SDL could not create the texture
+            bool create(SDL_Renderer* renderer, int w, int h);
+
+            /// @brief Map the texture for writing, every draw call needs the
+            /// buffer to be locked
+            /// @return false if SDL could not lock the texture
+            bool lock();
+
+            /// @brief Unlock the texture and copy it to the current render target
+            /// @param renderer is the renderer to draw with
+            /// @param dst is where to draw the frame, nullptr for the whole target
+            void present(SDL_Renderer* renderer, const SDL_Rect* dst = nullptr);
+
+            /// @brief Pack a color the way the buffer stores it
+            static Uint32 color(Uint8 r, Uint8 g, Uint8 b);
+
+            void clear(Uint32 color);
+
+            /// @brief Draw the vertical span between y0 and y1, both inclusive
+            void drawColumn(int x, int y0, int y1, Uint32 color);
+
+            /// @brief Stretch a column of texels over the vertical span [top, top + h)
+            /// @param x is the column of the buffer
+            /// @param top is where the first texel starts, may be off screen
+            /// @param h is the height the texels are stretched to, nothing is drawn
+            /// unless it is positive and finite
+            /// @param texels is texSize contiguous texels, top to bottom
+            /// @param texSize is the number of texels
+            /// @param darken halves the brightness, to tell wall sides apart
+            void drawTexturedColumn(int x, float top, float h, const Uint32* texels, int texSize, bool darken = false);
+
+            /// @brief Sample a tile along a straight line over the row span [x0, x1),
+            /// the way a floor or ceiling row is textured. The coordinates advance
+            /// by a fixed step per pixel and wrap around the tile
+            /// @param y is the row of the buffer
+            /// @param x0 is the first column, where the texel coordinates are u, v
+            /// @param x1 is one past the last column
+            /// @param u is the horizontal texel coordinate at x0, any value
+            /// @param v is the vertical texel coordinate at x0, any value
+            /// @param du is what u advances by per column
+            /// @param dv is what v advances by per column
+            /// @param texels is a texSize x texSize tile, column after column
+            /// @param texSize is the size of the tile, a power of two
+            /// @param darken halves the brightness
+            void drawTexturedRow(int y, int x0, int x1, float u, float v, float du, float dv,
+                                 const Uint32* texels, int texSize, bool darken = false);
+
+            void fillRect(const SDL_Rect& rect, Uint32 color);
+
+            /// @brief Draw the one pixel outline of a rect
+            void drawRect(const SDL_Rect& rect, Uint32 color);
+
+            /// @brief Draw a line between two points, clipped to the buffer
+            void drawLine(float x1, float y1, float x2, float y2, Uint32 color);
+
+            Uint32* getPixels();
+
+            /// @brief Get the distance between two rows, in pixels
+            int getPitch() const;
+
+            int getWidth() const;
+
+            int getHeight() const;
+
+        private:
+            SDL_Texture* texture = nullptr;
+            Uint32* pixels = nullptr;   // only valid while locked
+            int pitch = 0;
+            int width = 0;
+            int height = 0;
+    };
+
+
+    inline Framebuffer::~Framebuffer()
+    {
+        if(texture) SDL_DestroyTexture(texture);
+    }
+
+    inline bool Framebuffer::create(SDL_Renderer *renderer, int w, int h)
+    {
+        if(texture) SDL_DestroyTexture(texture);
+        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+        if(!texture) return false;
+
+        // every pixel is opaque, skip blending when the frame is copied
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+        width = w;
+        height = h;
+        return true;
+    }
+
+    inline bool Framebuffer::lock()
+    {
+        void* data = nullptr;
+        int bytePitch = 0;
+        if(SDL_LockTexture(texture, nullptr, &data, &bytePitch) != 0) return false;
+        pixels = static_cast<Uint32*>(data);
+        pitch = bytePitch / sizeof(Uint32);
+        return true;
+    }
+
+    inline void Framebuffer::present(SDL_Renderer *renderer, const SDL_Rect *dst)
+    {
+        if(pixels) {
+            SDL_UnlockTexture(texture);
+            pixels = nullptr;
+        }
+        SDL_RenderCopy(renderer, texture, nullptr, dst);
+    }
+
+    inline Uint32 Framebuffer::color(Uint8 r, Uint8 g, Uint8 b)
+    {
+        return 0xff000000u | (Uint32(r) << 16) | (Uint32(g) << 8) | Uint32(b);
+    }
+
+    inline void Framebuffer::clear(Uint32 color)
+    {
+        for(int y = 0; y < height; y++)
+            std::fill_n(pixels + y * pitch, width, color);
+    }
+
+    inline void Framebuffer::drawColumn(int x, int y0, int y1, Uint32 color)
+    {
+        if(x < 0 || x >= width) return;
+        if(y0 > y1) std::swap(y0, y1);
+        y0 = std::max(y0, 0);
+        y1 = std::min(y1, height - 1);
+        for(Uint32* p = pixels + y0 * pitch + x; y0 <= y1; y0++, p += pitch)
+            *p = color;
+    }
+
+    inline void Framebuffer::drawTexturedColumn(int x, float top, float h, const Uint32 *texels, int texSize, bool darken)
+    {
+        // a ray of length 0 gives an infinite h, and h from NaN compares false
+        if(!texels || x < 0 || x >= width || !(h > 0.0f) || !std::isfinite(h) || !std::isfinite(top)) return;
+        // clamped while still float, a huge but finite wall does not fit in an int
+        const int y0 = int(std::clamp(std::ceil(top), 0.0f, float(height)));
+        const int y1 = int(std::clamp(std::ceil(top + h), 0.0f, float(height)));
+        if(y0 >= y1) return;
+
+        // only rows on screen are sampled, however tall the wall is
+        const float step = texSize / h;
+        float v = (y0 - top) * step;
+        const Uint32 mask = darken ? 0xff7f7f7fu : 0xffffffffu;
+        const int shift = darken ? 1 : 0;
+        Uint32* p = pixels + y0 * pitch + x;
+        for(int y = y0; y < y1; y++, p += pitch, v += step)
+            *p = ((texels[std::min(int(v), texSize - 1)] >> shift) & mask) | 0xff000000u;
+    }
+
+    inline void Framebuffer::drawTexturedRow(int y, int x0, int x1, float u, float v, float du, float dv,
+                                             const Uint32 *texels, int texSize, bool darken)
+    {
+        if(!texels || y < 0 || y >= height || texSize <= 0 || (texSize & (texSize - 1)) != 0) return;
+        if(x0 < 0) {
+            u -= du * x0;
+            v -= dv * x0;
+            x0 = 0;
+        }
+        x1 = std::min(x1, width);
+
+        // 16.16 fixed point, with the tile taken off first so the start fits.
+        // Unsigned sums wrap modulo 2^32, a multiple of the tile, so the mask
+        // keeps wrapping right however far the row runs
+        const float size = float(texSize);
+        u -= std::floor(u / size) * size;
+        v -= std::floor(v / size) * size;
+        Uint32 fu = Uint32(u * 65536.0f), fv = Uint32(v * 65536.0f);
+        const Uint32 fdu = Uint32(Sint32(std::lround(du * 65536.0f)));
+        const Uint32 fdv = Uint32(Sint32(std::lround(dv * 65536.0f)));
+
+        const int bits = std::countr_zero(unsigned(texSize));
+        const Uint32 wrap = Uint32(texSize - 1);
+        const Uint32 mask = darken ? 0xff7f7f7fu : 0xffffffffu;
+        const int shift = darken ? 1 : 0;
+        Uint32* p = pixels + y * pitch;
+        for(int x = x0; x < x1; x++, fu += fdu, fv += fdv)
+        {
+            const Uint32 column = (fu >> 16) & wrap, row = (fv >> 16) & wrap;
+            p[x] = ((texels[(column << bits) | row] >> shift) & mask) | 0xff000000u;
+        }
+    }
+
+    inline void Framebuffer::fillRect(const SDL_Rect &rect, Uint32 color)
+    {
+        const int x0 = std::max(rect.x, 0), x1 = std::min(rect.x + rect.w, width);
+        const int y0 = std::max(rect.y, 0), y1 = std::min(rect.y + rect.h, height);
+        if(x0 >= x1) return;
+        for(int y = y0; y < y1; y++)
+            std::fill(pixels + y * pitch + x0, pixels + y * pitch + x1, color);
+    }
+
+    inline void Framebuffer::drawRect(const SDL_Rect &rect, Uint32 color)
+    {
+        fillRect({ rect.x, rect.y, rect.w, 1 }, color);
+        fillRect({ rect.x, rect.y + rect.h - 1, rect.w, 1 }, color);
+        fillRect({ rect.x, rect.y, 1, rect.h }, color);
+        fillRect({ rect.x + rect.w - 1, rect.y, 1, rect.h }, color);
+    }
+
+    inline void Framebuffer::drawLine(float x1, float y1, float x2, float y2, Uint32 color)
+    {
+        // clip first so a ray leaving the map does not walk thousands of
+        // off-screen pixels
+        int ax = std::floor(x1), ay = std::floor(y1);
+        int bx = std::floor(x2), by = std::floor(y2);
+        const SDL_Rect bounds{ 0, 0, width, height };
+        if(!SDL_IntersectRectAndLine(&bounds, &ax, &ay, &bx, &by)) return;
+
+        // Bresenham
+        const int dx = std::abs(bx - ax), sx = ax < bx ? 1 : -1;
+        const int dy = -std::abs(by - ay), sy = ay < by ? 1 : -1;
+        int err = dx + dy;
+        while (true)
+        {
+            pixels[ay * pitch + ax] = color;
+            if(ax == bx && ay == by) break;
+            const int e2 = 2 * err;
+            if(e2 >= dy) { err += dy; ax += sx; }
+            if(e2 <= dx) { err += dx; ay += sy; }
+        }
+    }
+
+    inline Uint32 *Framebuffer::getPixels()
+    {
+        return pixels;
+    }
+
+    inline int Framebuffer::getPitch() const
+    {
+        return pitch;
+    }
+
+    inline int Framebuffer::getWidth() const
+    {
+        return width;
+    }
+
+    inline int Framebuffer::getHeight() const
+    {
+        return height;
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,463 @@
+/**
+ * @file profiler.h
+ * @date 16-oct-2026
+ * A frame profiler for the examples. DL2HUB_PROFILE_SCOPE("name") times the
+ * rest of the enclosing scope; every thread records into its own ring
+ * buffer without locks, and Profiler::endFrame() drains the rings once per
+ * frame into per-stage totals and a rolling history. The HUD, toggled
+ * with F3, draws the history as a stacked frame-time graph with the
+ * average of every stage next to it.
+ *
+ * Stage names must be string literals or otherwise live for the whole
+ * run, only the pointer is recorded. Stages timed on several threads add
+ * up, so they can take longer than the frame. Only the stages timed at the
+ * top level of the thread that ends frames are stacked in the graph, so it
+ * adds up; nested stages and stages of other threads are listed below them.
+ * Built with trace export, scopes and frames also go to the trace, see
+ * trace.h. Built with DL2HUB_NO_PROFILE (the DL2HUB_PROFILE CMake option set
+ * to OFF), DL2HUB_PROFILE_SCOPE compiles to nothing and the HUD only shows
+ * frame times
+ */
+#ifndef __BYTENOL_DL2HUB_PROFILER_H__
+#define __BYTENOL_DL2HUB_PROFILER_H__
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <SDL.h>
+
+#include "trace.h"
+
+
+#define DL2HUB_PROFILE_CONCAT_(a, b) a##b
+#define DL2HUB_PROFILE_CONCAT(a, b) DL2HUB_PROFILE_CONCAT_(a, b)
+
+/// Time the rest of the enclosing scope as the stage name
+#ifdef DL2HUB_NO_PROFILE
+    #define DL2HUB_PROFILE_SCOPE(name) ((void)0)
+#else
+    #define DL2HUB_PROFILE_SCOPE(name) dl2hub::ScopedTimer DL2HUB_PROFILE_CONCAT(dl2hubProfileScope, __LINE__)(name)
+#endif
+
+
+namespace dl2hub
+{
+
+    /// The timed scopes of one thread. Only the owning thread pushes and only
+    /// Profiler::endFrame() drains, so the write index is the only thing the
+    /// two have to agree on
+    class ProfileRing
+    {
+        public:
+            static constexpr std::uint64_t capacity = 4096;
+
+            void push(const char* name, std::uint64_t start, std::uint64_t end, std::uint32_t depth);
+
+            /// @brief Call fn(name, start, end, depth) for every event pushed since the
+            /// last drain. Events the owner overwrote before they were read are lost
+            template<typename Fn>
+            void drain(Fn&& fn);
+
+        private:
+            // relaxed atomics compile to plain moves, they only make reading a
+            // slot the owner is rewriting well defined
+            struct Slot
+            {
+                std::atomic<const char*> name{ nullptr };
+                std::atomic<std::uint64_t> start{ 0 };
+                std::atomic<std::uint64_t> end{ 0 };
+                std::atomic<std::uint32_t> depth{ 0 };
+            };
+
+            std::array<Slot, capacity> slots;
+            std::atomic<std::uint64_t> head{ 0 };  // events ever pushed
+            std::uint64_t tail = 0;                 // events ever drained
+    };
+
+
+    class Profiler
+    {
+        public:
+            static constexpr int historySize = 128;     // frames in the graph
+            static constexpr int maxStages = 12;        // stages past this are not shown
+
+            struct Stage
+            {
+                const char* name = nullptr;
+                float lastMs = 0.0f;    // total in the last frame
+                float avgMs = 0.0f;     // total per frame over the history
+                bool stacked = false;   // timed at the top level of the frame thread
+            };
+
+            /// @brief Get the profiler shared by every thread
+            static Profiler& get();
+
+            /// @brief Get the time in nanoseconds on the clock events are recorded with
+            static std::uint64_t now();
+
+            /// @brief Record a timed event on the calling thread
+            /// @param depth is how many timed scopes enclose the event
+            void record(const char* name, std::uint64_t start, std::uint64_t end, std::uint32_t depth = 0);
+
+            /// @brief Close the current frame: drain every thread's events into
+            /// the stages and push the frame time into the history
+            void endFrame();
+
+            /// @brief Toggle the HUD on F3
+            /// @return true if the event was the toggle key
+            bool handleEvent(const SDL_Event& evt);
+
+            void setVisible(bool visible);
+
+            bool isVisible() const;
+
+            /// @brief Draw the HUD over whatever is rendered, if it is visible
+            /// @param renderer is the renderer to draw with
+            /// @param x is the left edge of the HUD
+            /// @param y is the top edge of the HUD
+            void drawHud(SDL_Renderer* renderer, int x = 8, int y = 8) const;
+
+            /// @brief Get the stages in the order they were first seen
+            const std::vector<Stage>& getStages() const;
+
+            /// @brief Get the length of the last frame in milliseconds
+            float getFrameMs() const;
+
+        private:
+            Profiler() = default;
+
+            ProfileRing& getThreadRing();
+            static ProfileRing*& findThreadRing();     // nullptr until the thread records
+            int getStageIndex(const char* name);
+
+            std::mutex ringsMutex;
+            std::vector<std::unique_ptr<ProfileRing>> rings;    // kept after their thread exits
+
+            std::vector<Stage> stages;
+            std::array<float, maxStages> frameStageMs{};
+            std::array<std::array<float, maxStages>, historySize> stageHistory{};
+            std::array<float, historySize> frameHistory{};
+            int historyHead = 0;        // the slot the next frame goes into
+            int historyCount = 0;
+            std::uint64_t frameStart = 0;
+            bool visible = false;
+    };
+
+
+    class ScopedTimer
+    {
+        public:
+            explicit ScopedTimer(const char* name);
+            ~ScopedTimer();
+
+            ScopedTimer(const ScopedTimer&) = delete;
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        private:
+            static std::uint32_t& getDepth();
+
+            const char* name;
+            std::uint64_t start;
+    };
+
+
+    inline void ProfileRing::push(const char *name, std::uint64_t start, std::uint64_t end, std::uint32_t depth)
+    {
+        const std::uint64_t index = head.load(std::memory_order_relaxed);
+        Slot& slot = slots[index % capacity];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.start.store(start, std::memory_order_relaxed);
+        slot.end.store(end, std::memory_order_relaxed);
+        slot.depth.store(depth, std::memory_order_relaxed);
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    template<typename Fn>
+    inline void ProfileRing::drain(Fn &&fn)
+    {
+        const std::uint64_t last = head.load(std::memory_order_acquire);
+        tail = std::max(tail, last > capacity ? last - capacity + 1 : 0);
+
+        struct Event { const char* name; std::uint64_t start, end; std::uint32_t depth; };
+        Event events[64];
+        while (tail < last)
+        {
+            const std::uint64_t count = std::min<std::uint64_t>(last - tail, 64);
+            for(std::uint64_t i = 0; i < count; i++) {
+                const Slot& slot = slots[(tail + i) % capacity];
+                events[i] = { slot.name.load(std::memory_order_relaxed),
+                              slot.start.load(std::memory_order_relaxed),
+                              slot.end.load(std::memory_order_relaxed),
+                              slot.depth.load(std::memory_order_relaxed) };
+            }
+
+            // slots the owner reached while they were copied, including the one
+            // it may be writing now, hold newer events
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const std::uint64_t now = head.load(std::memory_order_relaxed);
+            for(std::uint64_t i = 0; i < count; i++)
+                if(tail + i + capacity > now) fn(events[i].name, events[i].start, events[i].end, events[i].depth);
+            tail += count;
+        }
+    }
+
+
+    inline Profiler &Profiler::get()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    inline std::uint64_t Profiler::now()
+    {
+        using namespace std::chrono;
+        return std::uint64_t(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+
+    inline void Profiler::record(const char *name, std::uint64_t start, std::uint64_t end, std::uint32_t depth)
+    {
+        getThreadRing().push(name, start, end, depth);
+    }
+
+    inline ProfileRing *&Profiler::findThreadRing()
+    {
+        thread_local ProfileRing* ring = nullptr;
+        return ring;
+    }
+
+    inline ProfileRing &Profiler::getThreadRing()
+    {
+        // the lock is only taken the first time a thread records
+        ProfileRing*& ring = findThreadRing();
+        if(!ring) {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            rings.push_back(std::make_unique<ProfileRing>());
+            ring = rings.back().get();
+        }
+        return *ring;
+    }
+
+    inline int Profiler::getStageIndex(const char *name)
+    {
+        // the same literal can have a different address in another translation unit
+        for(size_t i = 0; i < stages.size(); i++)
+            if(stages[i].name == name || std::strcmp(stages[i].name, name) == 0) return int(i);
+        if(stages.size() >= size_t(maxStages)) return -1;
+        stages.push_back({ name });
+        return int(stages.size()) - 1;
+    }
+
+    inline void Profiler::endFrame()
+    {
+        frameStageMs.fill(0.0f);
+        const ProfileRing* own = findThreadRing();
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            for(auto& ring: rings)
+                ring->drain([&](const char* name, std::uint64_t start, std::uint64_t end, std::uint32_t depth) {
+                    const int i = getStageIndex(name);
+                    if(i < 0) return;
+                    frameStageMs[i] += (end - start) * 1e-6f;
+                    if(depth == 0 && ring.get() == own) stages[i].stacked = true;
+                });
+        }
+
+        const std::uint64_t t = now();
+        const float frameMs = frameStart ? (t - frameStart) * 1e-6f : 0.0f;
+        if(frameStart) {
+            DL2HUB_TRACE_EVENT("frame", frameStart, t);
+        } else {
+            DL2HUB_TRACE_THREAD_NAME("main");
+        }
+        frameStart = t;
+
+        frameHistory[historyHead] = frameMs;
+        stageHistory[historyHead] = frameStageMs;
+        historyHead = (historyHead + 1) % historySize;
+        historyCount = std::min(historyCount + 1, historySize);
+
+        for(size_t i = 0; i < stages.size(); i++)
+        {
+            float sum = 0.0f;
+            for(int f = 0; f < historyCount; f++)
+                sum += stageHistory[f][i];
+            stages[i].lastMs = frameStageMs[i];
+            stages[i].avgMs = sum / historyCount;
+        }
+    }
+
+    inline bool Profiler::handleEvent(const SDL_Event &evt)
+    {
+        if(evt.type != SDL_KEYDOWN || evt.key.keysym.sym != SDLK_F3 || evt.key.repeat) return false;
+        visible = !visible;
+        return true;
+    }
+
+    inline void Profiler::setVisible(bool visible)
+    {
+        this->visible = visible;
+    }
+
+    inline bool Profiler::isVisible() const
+    {
+        return visible;
+    }
+
+    inline const std::vector<Profiler::Stage> &Profiler::getStages() const
+    {
+        return stages;
+    }
+
+    inline float Profiler::getFrameMs() const
+    {
+        return frameHistory[(historyHead + historySize - 1) % historySize];
+    }
+
+    inline void Profiler::drawHud(SDL_Renderer *renderer, int x, int y) const
+    {
+        if(!visible) return;
+
+        // 3x5 glyphs, three bits per row from the top, the left pixel is the high bit
+        static const char glyphChars[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.:-/%";
+        static const std::uint16_t glyphBits[] = {
+            0x7b6f, 0x2c97, 0x73e7, 0x73cf, 0x5bc9, 0x79cf, 0x79ef, 0x7249, 0x7bef, 0x7bcf,
+            0x2bed, 0x6bae, 0x3923, 0x6b6e, 0x79a7, 0x79a4, 0x396b, 0x5bed, 0x7497, 0x126a,
+            0x5bad, 0x4927, 0x5fed, 0x6b6d, 0x2b6a, 0x6ba4, 0x2b73, 0x6bad, 0x388e, 0x7492,
+            0x5b6f, 0x5b6a, 0x5bfd, 0x5aad, 0x5a92, 0x72a7, 0x0002, 0x0410, 0x01c0, 0x12a4,
+            0x52a5,
+        };
+        const int scale = 2;
+        std::vector<SDL_Rect> rects;
+        auto addText = [&](int px, int py, const char* text) {
+            for(; *text; text++, px += 4 * scale)
+            {
+                const char c = char(std::toupper(static_cast<unsigned char>(*text)));
+                const char* found = std::strchr(glyphChars, c);
+                if(!found) continue;
+                const std::uint16_t bits = glyphBits[found - glyphChars];
+                for(int row = 0; row < 5; row++)
+                    for(int col = 0; col < 3; col++)
+                        if(bits & (1 << (14 - row * 3 - col)))
+                            rects.push_back({ px + col * scale, py + row * scale, scale, scale });
+            }
+        };
+        auto flush = [&](Uint8 r, Uint8 g, Uint8 b) {
+            SDL_SetRenderDrawColor(renderer, r, g, b, 0xff);
+            SDL_RenderFillRects(renderer, rects.data(), int(rects.size()));
+            rects.clear();
+        };
+        static const Uint8 palette[maxStages][3] = {
+            { 0xe6, 0x4b, 0x3c }, { 0x3c, 0xb4, 0x4b }, { 0x42, 0x87, 0xf5 }, { 0xff, 0xd2, 0x1e },
+            { 0xf5, 0x82, 0x31 }, { 0x91, 0x1e, 0xb4 }, { 0x46, 0xf0, 0xf0 }, { 0xf0, 0x32, 0xe6 },
+            { 0xbc, 0xf6, 0x0c }, { 0xfa, 0xbe, 0xbe }, { 0x00, 0x80, 0x80 }, { 0xaa, 0x6e, 0x28 },
+        };
+
+        // a 33 ms tall graph, two pixels per frame, the oldest frame on the left
+        const int graphW = historySize * 2, graphH = 66;
+        const float pxPerMs = graphH / 33.3f;
+        const int lineH = 6 * scale;
+        const int panelW = graphW + 8 + 18 * 4 * scale;
+        const int panelH = std::max(graphH, int(std::max<size_t>(stages.size(), 1) + 1) * lineH) + 8;
+
+        SDL_BlendMode blend;
+        SDL_GetRenderDrawBlendMode(renderer, &blend);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xc0);
+        const SDL_Rect panel{ x, y, panelW, panelH };
+        SDL_RenderFillRect(renderer, &panel);
+        SDL_SetRenderDrawBlendMode(renderer, blend);
+
+        const int gx = x + 4, gy = y + 4;
+        const int first = (historyHead + historySize - historyCount) % historySize;
+
+        // the whole frame behind the stages, what is left showing is untimed
+        for(int f = 0; f < historyCount; f++)
+        {
+            const int h = std::min(graphH, int(frameHistory[(first + f) % historySize] * pxPerMs));
+            rects.push_back({ gx + (historySize - historyCount + f) * 2, gy + graphH - h, 2, h });
+        }
+        flush(0x60, 0x60, 0x60);
+
+        // stages stacked from the bottom, one draw call per stage
+        std::array<int, historySize> stackTop;
+        stackTop.fill(gy + graphH);
+        for(size_t s = 0; s < stages.size(); s++)
+        {
+            if(!stages[s].stacked) continue;
+            for(int f = 0; f < historyCount; f++)
+            {
+                const int h = int(stageHistory[(first + f) % historySize][s] * pxPerMs);
+                int& top = stackTop[f];
+                const int clipped = std::min(h, top - gy);
+                if(clipped <= 0) continue;
+                top -= clipped;
+                rects.push_back({ gx + (historySize - historyCount + f) * 2, top, 2, clipped });
+            }
+            flush(palette[s][0], palette[s][1], palette[s][2]);
+        }
+
+        // 60 and 30 fps
+        rects.push_back({ gx, gy + graphH - int(16.7f * pxPerMs), graphW, 1 });
+        rects.push_back({ gx, gy, graphW, 1 });
+        flush(0xff, 0xff, 0xff);
+
+        // the legend: frame time, the stacked stages with their colour, then
+        // the rest in grey. Every stage shows its average per frame
+        char line[64];
+        const int tx = gx + graphW + 8;
+        SDL_snprintf(line, sizeof(line), "FRAME %5.2f", double(getFrameMs()));
+        addText(tx + 4 * scale, gy, line);
+        flush(0xff, 0xff, 0xff);
+        int ty = gy;
+        if(stages.empty()) {
+            // nothing was timed, the scopes are compiled out or never ran
+            addText(tx + 4 * scale, ty + lineH, "NO STAGES");
+            flush(0xa0, 0xa0, 0xa0);
+        }
+        for(int pass = 0; pass < 2; pass++)
+        {
+            for(size_t s = 0; s < stages.size(); s++)
+            {
+                if(stages[s].stacked != (pass == 0)) continue;
+                ty += lineH;
+                if(pass == 0) rects.push_back({ tx, ty, 3 * scale, 5 * scale });
+                SDL_snprintf(line, sizeof(line), "%-10.10s %5.2f", stages[s].name, double(stages[s].avgMs));
+                addText(tx + 4 * scale, ty, line);
+                if(pass == 0) flush(palette[s][0], palette[s][1], palette[s][2]);
+                else flush(0xa0, 0xa0, 0xa0);
+            }
+        }
+    }
+
+
+    inline ScopedTimer::ScopedTimer(const char *name)
+    {
+        this->name = name;
+        getDepth()++;
+        start = Profiler::now();
+    }
+
+    inline ScopedTimer::~ScopedTimer()
+    {
+        const std::uint64_t end = Profiler::now();
+        Profiler::get().record(name, start, end, --getDepth());
+        DL2HUB_TRACE_EVENT(name, start, end);
+    }
+
+    inline std::uint32_t &ScopedTimer::getDepth()
+    {
+        thread_local std::uint32_t depth = 0;
+        return depth;
+    }
+
+}
+
+
+#endif
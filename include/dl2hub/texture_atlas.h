@@ -0,0 +1,114 @@
+/**
+ * @file texture_atlas.h
+ * @date 16-oct-2026
+ * Wall textures for column renderers. The source image is a horizontal
+ * strip of square tiles, each as tall as the image. Tiles are stored
+ * transposed (column-major), so drawing a vertical wall slice reads one
+ * contiguous run of texels instead of striding a whole image row per pixel
+ */
+#ifndef __BYTENOL_DL2HUB_TEXTURE_ATLAS_H__
+#define __BYTENOL_DL2HUB_TEXTURE_ATLAS_H__
+
+#include <vector>
+#include <algorithm>
+#include <SDL.h>
+
+
+namespace dl2hub
+{
+
+    class TextureAtlas
+    {
+        public:
+            /// @brief Load a BMP strip of tiles from disk
+            /// @param path is the path to the image
+            /// @return false if the file could not be read
+            bool load(const char* path);
+
+            /// @brief Copy the tiles out of a surface of any pixel format
+            /// @param surface is a strip of square tiles, it is not freed
+            /// @return false if the surface could not be converted
+            bool loadSurface(SDL_Surface* surface);
+
+            /// @brief Get one column of a tile as tileSize contiguous ARGB8888 texels,
+            /// top to bottom
+            /// @param tile is the index of the tile, wrapped to the tile count
+            /// @param u is the horizontal position in the tile, in [0, 1)
+            /// @return the texels, or nullptr while nothing is loaded
+            const Uint32* getColumn(int tile, float u) const;
+
+            /// @brief Get a whole tile as tileSize columns of tileSize texels, the
+            /// layout Framebuffer::drawTexturedRow samples
+            /// @param tile is the index of the tile, wrapped to the tile count
+            /// @return the texels, or nullptr while nothing is loaded
+            const Uint32* getTile(int tile) const;
+
+            int getTileSize() const;
+
+            int getTileCount() const;
+
+        private:
+            std::vector<Uint32> texels;     // [tile][column][row]
+            int tileSize = 0;
+            int tileCount = 0;
+    };
+
+
+    inline bool TextureAtlas::load(const char *path)
+    {
+        SDL_Surface* surface = SDL_LoadBMP(path);
+        if(!surface) return false;
+        bool res = loadSurface(surface);
+        SDL_FreeSurface(surface);
+        return res;
+    }
+
+    inline bool TextureAtlas::loadSurface(SDL_Surface *surface)
+    {
+        SDL_Surface* argb = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        if(!argb) return false;
+
+        tileSize = argb->h;
+        tileCount = tileSize ? argb->w / tileSize : 0;
+        texels.resize(size_t(tileCount) * tileSize * tileSize);
+
+        SDL_LockSurface(argb);
+        const int pitch = argb->pitch / sizeof(Uint32);
+        const Uint32* pixels = static_cast<const Uint32*>(argb->pixels);
+        for(int tile = 0; tile < tileCount; tile++)
+            for(int u = 0; u < tileSize; u++)
+                for(int v = 0; v < tileSize; v++)
+                    texels[(size_t(tile) * tileSize + u) * tileSize + v] = pixels[v * pitch + tile * tileSize + u];
+        SDL_UnlockSurface(argb);
+
+        SDL_FreeSurface(argb);
+        return tileCount > 0;
+    }
+
+    inline const Uint32 *TextureAtlas::getColumn(int tile, float u) const
+    {
+        if(tileCount == 0) return nullptr;
+        tile = ((tile % tileCount) + tileCount) % tileCount;
+        const int column = std::clamp(int(u * tileSize), 0, tileSize - 1);
+        return texels.data() + (size_t(tile) * tileSize + column) * tileSize;
+    }
+
+    inline const Uint32 *TextureAtlas::getTile(int tile) const
+    {
+        return getColumn(tile, 0.0f);
+    }
+
+    inline int TextureAtlas::getTileSize() const
+    {
+        return tileSize;
+    }
+
+    inline int TextureAtlas::getTileCount() const
+    {
+        return tileCount;
+    }
+
+}
+
+
+#endif
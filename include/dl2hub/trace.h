@@ -0,0 +1,195 @@
+/**
+ * @file trace.h
+ * @date 16-oct-2026
+ * Chrome trace export for the examples. Built with DL2HUB_ENABLE_TRACE
+ * (the DL2HUB_TRACE CMake option), every DL2HUB_PROFILE_SCOPE also goes into
+ * a per-thread buffer, and if the DL2HUB_TRACE environment variable names
+ * a file, the buffers are written there at exit as trace event JSON that
+ * chrome://tracing and ui.perfetto.dev open. Without the define none of
+ * this is compiled and DL2HUB_TRACE_EVENT is a no-op.
+ *
+ * Scope names are written to the JSON as they are, keep them to plain
+ * identifiers
+ */
+#ifndef __BYTENOL_DL2HUB_TRACE_H__
+#define __BYTENOL_DL2HUB_TRACE_H__
+
+#ifdef DL2HUB_ENABLE_TRACE
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+/// Record a finished scope, timed in nanoseconds on the steady clock
+#define DL2HUB_TRACE_EVENT(name, start, end) dl2hub::Tracer::get().record(name, start, end)
+
+/// Name the calling thread in the trace
+#define DL2HUB_TRACE_THREAD_NAME(name) dl2hub::Tracer::get().nameThread(name)
+
+
+namespace dl2hub
+{
+
+    class Tracer
+    {
+        public:
+            static constexpr size_t maxEventsPerThread = size_t(1) << 22;   // ~100 MB, events past it are dropped
+
+            /// @brief Get the tracer shared by every thread
+            static Tracer& get();
+
+            ~Tracer();
+
+            Tracer(const Tracer&) = delete;
+            Tracer& operator=(const Tracer&) = delete;
+
+            /// @brief Check whether DL2HUB_TRACE named a file to write
+            bool isEnabled() const;
+
+            /// @brief Record a finished scope on the calling thread
+            /// @param name is the name of the scope, it has to outlive the tracer
+            /// @param start is when the scope began, in steady clock nanoseconds
+            /// @param end is when the scope ended, in steady clock nanoseconds
+            void record(const char* name, std::uint64_t start, std::uint64_t end);
+
+            /// @brief Name the calling thread in the trace
+            /// @param name has to outlive the tracer
+            void nameThread(const char* name);
+
+            /// @brief Write every event recorded so far, the destructor does it at exit
+            /// @return false if tracing is off or the file could not be written
+            bool flush();
+
+        private:
+            struct Event
+            {
+                const char* name;
+                std::uint64_t start;
+                std::uint64_t end;
+            };
+
+            // only its thread appends, flush() reads once the threads are done
+            struct ThreadBuffer
+            {
+                int tid = 0;
+                const char* name = nullptr;
+                std::vector<Event> events;
+                size_t dropped = 0;
+            };
+
+            Tracer();
+            ThreadBuffer& getThreadBuffer();
+
+            std::string path;
+            std::mutex threadsMutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> threads;
+    };
+
+
+    inline Tracer &Tracer::get()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    inline Tracer::Tracer()
+    {
+        const char* env = std::getenv("DL2HUB_TRACE");
+        if(env) path = env;
+    }
+
+    inline Tracer::~Tracer()
+    {
+        flush();
+    }
+
+    inline bool Tracer::isEnabled() const
+    {
+        return !path.empty();
+    }
+
+    inline void Tracer::record(const char *name, std::uint64_t start, std::uint64_t end)
+    {
+        if(!isEnabled()) return;
+        ThreadBuffer& buffer = getThreadBuffer();
+        if(buffer.events.size() >= maxEventsPerThread) {
+            buffer.dropped++;
+            return;
+        }
+        buffer.events.push_back({ name, start, end });
+    }
+
+    inline void Tracer::nameThread(const char *name)
+    {
+        if(isEnabled()) getThreadBuffer().name = name;
+    }
+
+    inline Tracer::ThreadBuffer &Tracer::getThreadBuffer()
+    {
+        // the lock is only taken the first time a thread records
+        thread_local ThreadBuffer* buffer = nullptr;
+        if(!buffer) {
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            threads.push_back(std::make_unique<ThreadBuffer>());
+            buffer = threads.back().get();
+            buffer->tid = int(threads.size());
+            buffer->events.reserve(size_t(1) << 16);
+        }
+        return *buffer;
+    }
+
+    inline bool Tracer::flush()
+    {
+        if(!isEnabled()) return false;
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if(!file) {
+            std::fprintf(stderr, "Unable to write trace %s\n", path.c_str());
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        std::uint64_t epoch = UINT64_MAX;
+        for(const auto& thread: threads)
+            for(const Event& e: thread->events)
+                epoch = e.start < epoch ? e.start : epoch;
+
+        // complete ("X") events carry both ends of a scope, in microseconds
+        std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        const char* separator = "\n";
+        for(const auto& thread: threads)
+        {
+            char fallback[32];
+            std::snprintf(fallback, sizeof(fallback), "thread %d", thread->tid);
+            std::fprintf(file, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}",
+                         separator, thread->tid, thread->name ? thread->name : fallback);
+            separator = ",\n";
+
+            for(const Event& e: thread->events)
+                std::fprintf(file, ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"name\":\"%s\",\"ts\":%.3f,\"dur\":%.3f}",
+                             thread->tid, e.name, (e.start - epoch) * 1e-3, (e.end - e.start) * 1e-3);
+            if(thread->dropped)
+                std::fprintf(stderr, "Trace buffer of thread %d full, %zu events dropped\n", thread->tid, thread->dropped);
+        }
+        std::fprintf(file, "\n]}\n");
+
+        const bool ok = std::fclose(file) == 0;
+        if(ok) std::fprintf(stderr, "Wrote trace to %s\n", path.c_str());
+        return ok;
+    }
+
+}
+
+#else
+
+#define DL2HUB_TRACE_EVENT(name, start, end) ((void)0)
+#define DL2HUB_TRACE_THREAD_NAME(name) ((void)0)
+
+#endif
+
+
+#endif